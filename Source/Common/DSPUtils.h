@@ -17,11 +17,13 @@ namespace ultraglitch::dsp
         return std::clamp(value, min_value, max_value);
     }
 
-    /** Linearly mixes two values (dry and wet) based on a mix factor (0.0 = dry, 1.0 = wet). */
-    template<typename T>
-    inline T mix(T dry_value, T wet_value, T mix_factor)
+    /** Linearly mixes two values (dry and wet) based on a mix factor (0.0 = dry, 1.0 = wet).
+        The factor may be float (smoothed parameters) while the samples are double. */
+    template<typename T, typename Factor = T>
+    inline T mix(T dry_value, T wet_value, Factor mix_factor)
     {
-        return dry_value * (1.0f - mix_factor) + wet_value * mix_factor;
+        const T factor = static_cast<T>(mix_factor);
+        return dry_value * (static_cast<T>(1) - factor) + wet_value * factor;
     }
 
     /** Linear interpolation between two values. */
@@ -85,6 +87,37 @@ namespace ultraglitch::dsp
         channel_data[wrap_delay_index(write_position, buffer_size)] = value;
     }
     
+    // =========================================================================
+    // Channel layout helpers
+    // =========================================================================
+
+    /** Copy numSamples samples from planar channels (starting at startSample) into frames:
+        frame i holds the numChannels samples of time step i, adjacent. */
+    template<typename T>
+    inline void interleave_channels(const T* const* channels, int numChannels, int startSample,
+                                    int numSamples, T* frames)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const T* source = channels[ch] + startSample;
+            for (int i = 0; i < numSamples; ++i)
+                frames[i * numChannels + ch] = source[i];
+        }
+    }
+
+    /** Inverse of interleave_channels(): frames back into planar channels. */
+    template<typename T>
+    inline void deinterleave_channels(const T* frames, int numChannels, int numSamples,
+                                      T* const* channels, int startSample)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            T* destination = channels[ch] + startSample;
+            for (int i = 0; i < numSamples; ++i)
+                destination[i] = frames[i * numChannels + ch];
+        }
+    }
+    
     // =========================================================================
     // Frequency and time conversions
     // =========================================================================
@@ -256,36 +289,39 @@ namespace ultraglitch::dsp
     static constexpr int CROSSFADE_SAMPLES = 32;
     
     /** Apply a linear fade-in ramp to the first N samples of a buffer region. */
-    inline void apply_fade_in(float* data, int startSample, int fadeLengthSamples, int totalSamples)
+    template<typename T>
+    inline void apply_fade_in(T* data, int startSample, int fadeLengthSamples, int totalSamples)
     {
         if (fadeLengthSamples <= 0) return;
         const int fadeEnd = std::min(startSample + fadeLengthSamples, totalSamples);
         for (int i = startSample; i < fadeEnd; ++i)
         {
-            float gain = static_cast<float>(i - startSample) / static_cast<float>(fadeLengthSamples);
+            T gain = static_cast<T>(i - startSample) / static_cast<T>(fadeLengthSamples);
             data[i] *= gain;
         }
     }
     
     /** Apply a linear fade-out ramp to the last N samples before regionEnd. */
-    inline void apply_fade_out(float* data, int regionEnd, int fadeLengthSamples)
+    template<typename T>
+    inline void apply_fade_out(T* data, int regionEnd, int fadeLengthSamples)
     {
         if (fadeLengthSamples <= 0) return;
         const int fadeStart = std::max(0, regionEnd - fadeLengthSamples);
         for (int i = fadeStart; i < regionEnd; ++i)
         {
-            float gain = static_cast<float>(regionEnd - i) / static_cast<float>(fadeLengthSamples);
+            T gain = static_cast<T>(regionEnd - i) / static_cast<T>(fadeLengthSamples);
             data[i] *= gain;
         }
     }
     
     /** Apply fade-in and fade-out to a slice within a buffer. */
-    inline void apply_slice_crossfade(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, int fadeLen = CROSSFADE_SAMPLES)
+    template<typename T>
+    inline void apply_slice_crossfade(juce::AudioBuffer<T>& buffer, int startSample, int numSamples, int fadeLen = CROSSFADE_SAMPLES)
     {
         if (numSamples < fadeLen * 2) return; // Slice too short for crossfade
         for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
         {
-            float* data = buffer.getWritePointer(ch);
+            T* data = buffer.getWritePointer(ch);
             apply_fade_in(data, startSample, fadeLen, startSample + numSamples);
             apply_fade_out(data, startSample + numSamples, fadeLen);
         }
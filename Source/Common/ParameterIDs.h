@@ -2,57 +2,166 @@
 #define PARAMETERIDS_H
 
 #include <juce_core/juce_core.h>
+#include <cstdint>
 
 namespace ultraglitch::params
 {
+    // Parameter IDs: inline constexpr literals, so there is a single copy and no
+    // static initialisation (they convert to juce::String / std::string_view on use).
+
     // Global parameters
-    const juce::String Global_Gain = "global_output_gain"; // Changed to match tasq.md
-    const juce::String Global_OutputGain = Global_Gain;       // Backward-compatible alias
-    const juce::String Global_ChaosMode = "global_chaos_mode"; // From tasq.md: chaosMode bool
+    inline constexpr const char* Global_Gain = "global_output_gain"; // Changed to match tasq.md
+    inline constexpr const char* Global_OutputGain = Global_Gain;       // Backward-compatible alias
+    inline constexpr const char* Global_ChaosMode = "global_chaos_mode"; // From tasq.md: chaosMode bool
 
     // SliceRearrange constants
-    static constexpr int SliceRearrange_MAX_SLICE_COUNT = 16;
+    inline constexpr int SliceRearrange_MAX_SLICE_COUNT = 16;
 
     // BitCrusher parameters
-    const juce::String BitCrusher_Enabled = "bc_enabled"; // From tasq.md: bcEnabled
-    const juce::String BitCrusher_BitDepth = "bc_bit_depth"; // From tasq.md: bcBitDepth
-    const juce::String BitCrusher_SampleRateDiv = "bc_samplerate_div"; // From tasq.md: bcSampleRateDiv
-    const juce::String BitCrusher_Mix = "bc_mix"; // From tasq.md: bcMix
+    inline constexpr const char* BitCrusher_Enabled = "bc_enabled"; // From tasq.md: bcEnabled
+    inline constexpr const char* BitCrusher_BitDepth = "bc_bit_depth"; // From tasq.md: bcBitDepth
+    inline constexpr const char* BitCrusher_SampleRateDiv = "bc_samplerate_div"; // From tasq.md: bcSampleRateDiv
+    inline constexpr const char* BitCrusher_Mix = "bc_mix"; // From tasq.md: bcMix
 
     // BufferStutter parameters
-    const juce::String BufferStutter_Enabled = "st_enabled"; // From tasq.md: stEnabled
-    const juce::String BufferStutter_Rate = "st_rate"; // From tasq.md: stRate
-    const juce::String BufferStutter_Length = "st_length"; // From tasq.md: stLength
-    const juce::String BufferStutter_Mix = "st_mix"; // From tasq.md: stMix
+    inline constexpr const char* BufferStutter_Enabled = "st_enabled"; // From tasq.md: stEnabled
+    inline constexpr const char* BufferStutter_Rate = "st_rate"; // From tasq.md: stRate
+    inline constexpr const char* BufferStutter_Length = "st_length"; // From tasq.md: stLength
+    inline constexpr const char* BufferStutter_Mix = "st_mix"; // From tasq.md: stMix
 
     // PitchDrift parameters
-    const juce::String PitchDrift_Enabled = "pd_enabled"; // From tasq.md: pdEnabled
-    const juce::String PitchDrift_Amount = "pd_amount"; // From tasq.md: pdAmount
-    const juce::String PitchDrift_Speed = "pd_speed"; // From tasq.md: pdSpeed
-    const juce::String PitchDrift_Mix = "pd_mix"; // From tasq.md: pdMix
+    inline constexpr const char* PitchDrift_Enabled = "pd_enabled"; // From tasq.md: pdEnabled
+    inline constexpr const char* PitchDrift_Amount = "pd_amount"; // From tasq.md: pdAmount
+    inline constexpr const char* PitchDrift_Speed = "pd_speed"; // From tasq.md: pdSpeed
+    inline constexpr const char* PitchDrift_Mix = "pd_mix"; // From tasq.md: pdMix
 
     // ReverseSlice parameters
-    const juce::String ReverseSlice_Enabled = "rs_enabled"; // From tasq.md: rsEnabled
-    const juce::String ReverseSlice_Interval = "rs_interval"; // From tasq.md: rsInterval
-    const juce::String ReverseSlice_Chance = "rs_chance"; // From tasq.md: rsChance
-    const juce::String ReverseSlice_Mix = "rs_mix"; // From tasq.md: rsMix
+    inline constexpr const char* ReverseSlice_Enabled = "rs_enabled"; // From tasq.md: rsEnabled
+    inline constexpr const char* ReverseSlice_Interval = "rs_interval"; // From tasq.md: rsInterval
+    inline constexpr const char* ReverseSlice_Chance = "rs_chance"; // From tasq.md: rsChance
+    inline constexpr const char* ReverseSlice_Mix = "rs_mix"; // From tasq.md: rsMix
 
     // SliceRearrange parameters
-    const juce::String SliceRearrange_Enabled = "sr_enabled"; // From tasq.md: srEnabled
-    const juce::String SliceRearrange_SliceCount = "sr_slice_count"; // From tasq.md: srSliceCount
-    const juce::String SliceRearrange_Randomize = "sr_randomize"; // From tasq.md: srRandomize
-    const juce::String SliceRearrange_Mix = "sr_mix"; // From tasq.md: srMix
+    inline constexpr const char* SliceRearrange_Enabled = "sr_enabled"; // From tasq.md: srEnabled
+    inline constexpr const char* SliceRearrange_SliceCount = "sr_slice_count"; // From tasq.md: srSliceCount
+    inline constexpr const char* SliceRearrange_Randomize = "sr_randomize"; // From tasq.md: srRandomize
+    inline constexpr const char* SliceRearrange_Mix = "sr_mix"; // From tasq.md: srMix
 
     // WeirdFlanger parameters
-    const juce::String WeirdFlanger_Enabled = "wf_enabled"; // From tasq.md: wfEnabled
-    const juce::String WeirdFlanger_Rate = "wf_rate"; // From tasq.md: wfRate
-    const juce::String WeirdFlanger_Depth = "wf_depth"; // From tasq.md: wfDepth
-    const juce::String WeirdFlanger_Feedback = "wf_feedback"; // From tasq.md: wfFeedback
-    const juce::String WeirdFlanger_Mix = "wf_mix"; // From tasq.md: wfMix
+    inline constexpr const char* WeirdFlanger_Enabled = "wf_enabled"; // From tasq.md: wfEnabled
+    inline constexpr const char* WeirdFlanger_Rate = "wf_rate"; // From tasq.md: wfRate
+    inline constexpr const char* WeirdFlanger_Depth = "wf_depth"; // From tasq.md: wfDepth
+    inline constexpr const char* WeirdFlanger_Feedback = "wf_feedback"; // From tasq.md: wfFeedback
+    inline constexpr const char* WeirdFlanger_Mix = "wf_mix"; // From tasq.md: wfMix
 
     // ChaosController parameters (from tasq.md ChaosController section)
-    const juce::String ChaosController_Speed = "chaos_speed"; // From tasq.md: chaosSpeed
-    const juce::String ChaosController_Intensity = "chaos_intensity"; // From tasq.md: chaosIntensity
+    inline constexpr const char* ChaosController_Speed = "chaos_speed"; // From tasq.md: chaosSpeed
+    inline constexpr const char* ChaosController_Intensity = "chaos_intensity"; // From tasq.md: chaosIntensity
+    inline constexpr const char* ChaosController_Slew = "chaos_slew"; // Morph glide time, 0 = hard jumps
+    inline constexpr const char* ChaosController_HostSync = "chaos_host_sync"; // Off = chaos stays internal (not published)
+    inline constexpr const char* ChaosController_Reorder = "chaos_reorder"; // Shuffle the chain order on each trigger
+
+    // Modulation route slots (ModulationMatrix routes 0 and 1, set from these parameters)
+    inline constexpr const char* Modulation1_Enabled = "mod1_enabled";
+    inline constexpr const char* Modulation1_Source = "mod1_source";
+    inline constexpr const char* Modulation1_Target = "mod1_target";
+    inline constexpr const char* Modulation1_Depth = "mod1_depth";
+    inline constexpr const char* Modulation2_Enabled = "mod2_enabled";
+    inline constexpr const char* Modulation2_Source = "mod2_source";
+    inline constexpr const char* Modulation2_Target = "mod2_target";
+    inline constexpr const char* Modulation2_Depth = "mod2_depth";
+
+    // Engine settings (non-automatable: they change the latency, applied by re-preparing)
+    inline constexpr const char* Engine_InternalRate = "engine_internal_rate"; // Chain at 44.1/48k behind a resampler
+    inline constexpr const char* Engine_Oversampling = "engine_oversampling"; // BitCrusher/WeirdFlanger factor, 1x = off
+
+    // Output limiter (enable is an engine setting: its lookahead is latency)
+    inline constexpr const char* Limiter_Enabled = "limiter_enabled";
+    inline constexpr const char* Limiter_Ceiling = "limiter_ceiling"; // dBTP
+
+    // Compile-time parameter index, one entry per ID above (aliases excluded).
+    // Order MUST match PARAMETER_REGISTRY (Parameters/ParameterRegistry.h), which
+    // static_asserts it, so that registry[index] and the APVTS parameter index line up.
+    enum class ParamIndex : int
+    {
+        Global_Gain = 0,
+        Global_ChaosMode,
+
+        BitCrusher_Enabled,
+        BitCrusher_BitDepth,
+        BitCrusher_SampleRateDiv,
+        BitCrusher_Mix,
+
+        BufferStutter_Enabled,
+        BufferStutter_Rate,
+        BufferStutter_Length,
+        BufferStutter_Mix,
+
+        PitchDrift_Enabled,
+        PitchDrift_Amount,
+        PitchDrift_Speed,
+        PitchDrift_Mix,
+
+        ReverseSlice_Enabled,
+        ReverseSlice_Interval,
+        ReverseSlice_Chance,
+        ReverseSlice_Mix,
+
+        SliceRearrange_Enabled,
+        SliceRearrange_SliceCount,
+        SliceRearrange_Randomize,
+        SliceRearrange_Mix,
+
+        WeirdFlanger_Enabled,
+        WeirdFlanger_Rate,
+        WeirdFlanger_Depth,
+        WeirdFlanger_Feedback,
+        WeirdFlanger_Mix,
+
+        ChaosController_Speed,
+        ChaosController_Intensity,
+        ChaosController_Slew,
+        ChaosController_HostSync,
+        ChaosController_Reorder,
+
+        Modulation1_Enabled,
+        Modulation1_Source,
+        Modulation1_Target,
+        Modulation1_Depth,
+        Modulation2_Enabled,
+        Modulation2_Source,
+        Modulation2_Target,
+        Modulation2_Depth,
+
+        Engine_InternalRate,
+        Engine_Oversampling,
+
+        Limiter_Enabled,
+        Limiter_Ceiling,
+
+        Count
+    };
+
+    static constexpr int NUM_PARAMETERS = static_cast<int>(ParamIndex::Count);
+
+    constexpr int to_int(ParamIndex index) { return static_cast<int>(index); }
+
+    // One bit per ParamIndex (dirty flags, modulation routing, ...)
+    using ParamMask = std::uint64_t;
+    static_assert(NUM_PARAMETERS <= 64, "ParamMask must hold one bit per parameter");
+
+    constexpr ParamMask to_mask(ParamIndex index) { return ParamMask{1} << static_cast<unsigned>(index); }
+    static constexpr ParamMask ALL_PARAMETERS_MASK = (ParamMask{1} << NUM_PARAMETERS) - 1;
+
+    // Index of the lowest set bit (mask must be non-zero). Iterate a mask with
+    // for (; mask != 0; mask &= mask - 1) { auto index = lowest_set_index(mask); ... }
+    constexpr ParamIndex lowest_set_index(ParamMask mask)
+    {
+        int bit = 0;
+        while ((mask & (ParamMask{1} << bit)) == 0)
+            ++bit;
+        return static_cast<ParamIndex>(bit);
+    }
 }
 
 #endif // PARAMETERIDS_H
\ No newline at end of file
@@ -21,14 +21,27 @@ namespace ultraglitch::config
     const bool SUPPORTS_STANDALONE = true; // Changed to true
     
     // Audio configuration
-    const int MAX_NUM_CHANNELS = 2;
+    const int MAX_NUM_CHANNELS = 16; // Any layout up to 16 channels (e.g. 7.1.4 + 4)
     const double DEFAULT_SAMPLE_RATE = 44100.0;
     const int DEFAULT_BLOCK_SIZE = 512; // This is a default, not a max
     const int MAX_BLOCK_SIZE = 8192; // Added as per tasq.md golden path test
+    const int INTERNAL_BLOCK_SIZE = 64; // Fixed sub-block grid the chain runs on, whatever the host block size
+    const double MIN_INTERNAL_SAMPLE_RATE = 44100.0; // Internal-rate mode never takes the chain below this
+    const int MAX_INTERNAL_RATE_FACTOR = 8; // Host rate / internal rate, a power of two (e.g. 352.8k -> 44.1k)
     
     // Effect chain configuration
     const int MAX_EFFECTS_IN_CHAIN = 8;
+    const int MAX_PARALLEL_BRANCHES = 4; // Per routing stage
+    const float ORDER_CHANGE_FADE_MS = 5.0f; // Fade-out (and again fade-in) around a chain reorder
+    const float BYPASS_FADE_MS = 10.0f; // Crossfade between an effect and its input when it is enabled/bypassed
     const int NUM_EFFECT_MODULES = 7;
+    const float SILENCE_THRESHOLD = 1.0e-5f; // About -100 dBFS; quieter input counts as silence (effect sleep)
+    const int MAX_OVERSAMPLING_FACTOR = 8; // OversampledEffect: 1, 2, 4 or 8
+    const int DEFAULT_OVERSAMPLING_FACTOR_REALTIME = 2; // Low-latency IIR half-bands while playing
+    const int DEFAULT_OVERSAMPLING_FACTOR_OFFLINE = 4; // Linear-phase FIR half-bands while rendering
+    const float LIMITER_CEILING_DB = -1.0f; // Output limiter ceiling, dBTP
+    const float LIMITER_LOOKAHEAD_MS = 1.5f; // Also its attack time
+    const float LIMITER_RELEASE_MS = 60.0f;
     
     // GUI configuration
     const int EDITOR_WIDTH = 800;
@@ -38,6 +51,8 @@ namespace ultraglitch::config
     
     // Parameter configuration
     const float PARAMETER_SMOOTHING_TIME_MS = 50.0f;
+    const int MIN_SUB_BLOCK_SAMPLES = 32; // Finest split processBlock makes at parameter change points
+    const int MODULATION_CONTROL_INTERVAL_SAMPLES = 32; // Modulation matrix control rate
     
     // Utility functions
     inline juce::String get_plugin_name() { return PLUGIN_NAME; }
@@ -54,6 +69,17 @@ namespace ultraglitch::config
         return sampleRate > 0.0 && sampleRate <= 192000.0;
     }
     
+    // Power-of-two factor the internal-rate mode divides the host rate by (1 at 44.1/48k,
+    // 2 at 88.2/96k, 4 at 176.4/192k); rates in between keep the chain at the host rate
+    inline int get_internal_rate_factor(double hostSampleRate)
+    {
+        int factor = 1;
+        while (factor < MAX_INTERNAL_RATE_FACTOR
+               && hostSampleRate / (2.0 * factor) >= MIN_INTERNAL_SAMPLE_RATE - 1.0)
+            factor *= 2;
+        return factor;
+    }
+    
     inline bool is_valid_block_size(int blockSize)
     {
         return blockSize > 0 && blockSize <= MAX_BLOCK_SIZE; // Using MAX_BLOCK_SIZE
@@ -1,4 +1,6 @@
 #include "EffectBase.h"
+#include "../Parameters/PluginParameters.h"
+#include "../Common/PluginConfig.h"
 
 namespace ultraglitch::dsp {
 void EffectBase::setEnabled(bool shouldBeEnabled)
@@ -13,11 +15,119 @@ bool EffectBase::isEnabled() const
 
 void EffectBase::setMix(float newMix)
 {
-    dryWetMix.store(juce::jlimit(0.0f, 1.0f, newMix));
+    const float clampedMix = juce::jlimit(0.0f, 1.0f, newMix);
+    dryWetMix.store(clampedMix);
+    mixSmoother_.setTargetValue(clampedMix);
 }
 
 float EffectBase::getMix() const
 {
     return dryWetMix.load();
 }
-}
\ No newline at end of file
+
+void EffectBase::prepareParameterSmoothing(double sampleRate, int maxBlockSize)
+{
+    mixSmoother_.prepare(sampleRate, maxBlockSize);
+}
+
+const float* EffectBase::getMixRamp(int numSamples)
+{
+    return mixSmoother_.getNextBlock(numSamples);
+}
+
+void EffectBase::setScratchArena(ScratchArena* arena)
+{
+    scratchArena_ = arena;
+}
+
+ScratchArena* EffectBase::getScratchArena() const
+{
+    return scratchArena_;
+}
+
+void EffectBase::setNumChannels(int numChannels)
+{
+    numChannels_ = juce::jlimit(1, ultraglitch::config::MAX_NUM_CHANNELS, numChannels);
+}
+
+int EffectBase::getNumChannels() const
+{
+    return numChannels_;
+}
+
+void EffectBase::setDoublePrecision(bool shouldUseDoublePrecision)
+{
+    doublePrecision_ = shouldUseDoublePrecision;
+}
+
+bool EffectBase::isDoublePrecision() const
+{
+    return doublePrecision_;
+}
+
+void EffectBase::setNonRealtime(bool shouldBeNonRealtime)
+{
+    nonRealtime_ = shouldBeNonRealtime;
+}
+
+bool EffectBase::isNonRealtime() const
+{
+    return nonRealtime_;
+}
+
+void EffectBase::setOversamplingFactor(int factor)
+{
+    oversamplingFactor_ = juce::jmax(1, factor);
+}
+
+int EffectBase::getOversamplingFactor() const
+{
+    return oversamplingFactor_;
+}
+
+bool EffectBase::handlesParameter(ultraglitch::params::ParamIndex index) const
+{
+    for (int i = 0; i < numParameterHandles_; ++i)
+    {
+        if (parameterHandles_[static_cast<size_t>(i)].getIndex() == index)
+            return true;
+    }
+    return false;
+}
+
+bool EffectBase::pullParameter(ultraglitch::params::ParamIndex index, float& appliedValue)
+{
+    for (int i = 0; i < numParameterHandles_; ++i)
+    {
+        const auto& handle = parameterHandles_[static_cast<size_t>(i)];
+        if (handle.getIndex() == index)
+        {
+            if (!handle.isBound())
+                return false;
+
+            appliedValue = handle.load();
+            setParameterValue(index, appliedValue);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void EffectBase::bindParameter(const PluginParameters* pluginParameters, ultraglitch::params::ParamIndex index)
+{
+    jassert(numParameterHandles_ < MAX_BOUND_PARAMETERS);
+    if (numParameterHandles_ >= MAX_BOUND_PARAMETERS)
+        return;
+
+    parameterHandles_[static_cast<size_t>(numParameterHandles_++)] =
+        pluginParameters != nullptr ? pluginParameters->get_parameter_handle(index)
+                                    : ParameterHandle(index, nullptr);
+}
+
+void EffectBase::bindParametersOf(const EffectBase& other)
+{
+    for (int i = 0; i < other.numParameterHandles_ && numParameterHandles_ < MAX_BOUND_PARAMETERS; ++i)
+        parameterHandles_[static_cast<size_t>(numParameterHandles_++)] = other.parameterHandles_[static_cast<size_t>(i)];
+}
+}
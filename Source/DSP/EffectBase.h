@@ -3,32 +3,176 @@
 #include <juce_core/juce_core.h> // For juce::jlimit
 #include <juce_audio_basics/juce_audio_basics.h> // For juce::AudioBuffer
 #include <atomic>
+#include <array>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include "../Common/ParameterIDs.h"
+#include "../Parameters/ParameterHandle.h"
+#include "ParameterSmoother.h"
+#include "ParameterChangeQueue.h"
+#include "ScratchArena.h"
+
+class PluginParameters; // Owned by the processor; effects only keep ParameterHandles
 
 namespace ultraglitch::dsp {
     class EffectBase {
     public:
         virtual ~EffectBase() = default;
         virtual void prepare(double sampleRate, int maxBlockSize) = 0;
+
+        // One per sample type; effects implement both from a single processSamples<SampleType>()
         virtual void process(juce::AudioBuffer<float>& buffer) = 0;
+        virtual void process(juce::AudioBuffer<double>& buffer) = 0;
         virtual void reset() = 0;
+
+        // Runs process() on [startSample, startSample + numSamples) of buffer through a
+        // non-owning view (no copy, no allocation for up to 32 channels)
+        template <typename SampleType>
+        void processRange(juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples)
+        {
+            jassert(startSample >= 0 && startSample + numSamples <= buffer.getNumSamples());
+
+            juce::AudioBuffer<SampleType> view(buffer.getArrayOfWritePointers(), buffer.getNumChannels(),
+                                               startSample, numSamples);
+            process(view);
+        }
+
+        // Samples until this effect changes parameters on its own (e.g. a chaos trigger).
+        // processBlock splits the host block there; the default means "never".
+        [[nodiscard]] virtual int getSamplesUntilNextChangePoint() const { return std::numeric_limits<int>::max(); }
+
+        // Samples the output needs to fall below config::SILENCE_THRESHOLD once the input has,
+        // for the current parameters. EffectChain stops calling process() after the input has
+        // been silent that long and calls it again as soon as it isn't. Default: never sleeps.
+        // std::numeric_limits<int>::max() means unbounded; EffectChain sums the tails of the
+        // enabled effects for the host (getTailLengthSeconds()).
+        [[nodiscard]] virtual int getTailSamples() const { return std::numeric_limits<int>::max(); }
+
+        // False for effects that have to keep running on silence (e.g. a trigger clock);
+        // those never sleep, whatever their tail
+        [[nodiscard]] virtual bool canSleep() const { return true; }
+
+        // False for effects whose process() never writes the buffer (e.g. a trigger clock).
+        // EffectChain then calls them without a dry copy, mix blend or bypass crossfade.
+        [[nodiscard]] virtual bool writesAudio() const { return true; }
+
+        // Delay process() adds to the signal, in samples; fixed from one prepare() to the next.
+        // EffectChain reports the sum to the host and delays a bypassed effect's input by as
+        // much, so enabling or bypassing it doesn't shift the signal. Default: none.
+        [[nodiscard]] virtual int getLatencySamples() const { return 0; }
         
         // Concrete methods, declarations remain here, implementations move to .cpp
         void setEnabled(bool enabled);
         [[nodiscard]] bool isEnabled() const;
         
+        // Dry/wet mix. process() writes the wet signal only; EffectChain blends it with the
+        // effect's input (and skips the effect altogether while the mix rests at 0).
         void setMix(float mix);
-        [[nodiscard]] float getMix() const;
+        [[nodiscard]] float getMix() const; // Target mix; see getMixRamp() for the smoothed value
+
+        // Per-sample mix for the next numSamples (EffectChain, once per process()), or
+        // nullptr when the mix is settled and getMix() can be used as a constant
+        const float* getMixRamp(int numSamples);
+
+        // Sizes the mix smoother; EffectChain calls this right before prepare()
+        void prepareParameterSmoothing(double sampleRate, int maxBlockSize);
+
+        // Per-chain temporary buffers (see ScratchArena); set by EffectChain::addEffect()
+        void setScratchArena(ScratchArena* arena);
+
+        // Channels process() will see (1..config::MAX_NUM_CHANNELS). EffectChain sets it right
+        // before prepare(), which sizes per-channel state from getNumChannels().
+        void setNumChannels(int numChannels);
+        [[nodiscard]] int getNumChannels() const;
+
+        // Sample type process() will be called with, set the same way. Effects size state
+        // only for the precision in use (see PrecisionStates).
+        void setDoublePrecision(bool shouldUseDoublePrecision);
+        [[nodiscard]] bool isDoublePrecision() const;
+
+        template <typename SampleType>
+        [[nodiscard]] bool isPreparedFor() const { return std::is_same_v<SampleType, double> == isDoublePrecision(); }
+
+        // Offline rendering (AudioProcessor::isNonRealtime()), set the same way: effects may
+        // spend more CPU on quality when nothing has to keep up with the audio clock
+        void setNonRealtime(bool shouldBeNonRealtime);
+        [[nodiscard]] bool isNonRealtime() const;
+
+        // Multiple of the chain's sample rate prepare() and process() run at (set by
+        // OversampledEffect). Effects with parameters counted in samples scale them by it.
+        void setOversamplingFactor(int factor);
+        [[nodiscard]] int getOversamplingFactor() const;
 
         // New virtual method for getting effect name
         virtual juce::String getName() const = 0;
 
-        // New virtual method for setting parameters by ID, with default no-op
-        virtual void setParameterValue(const juce::String& paramID, float value) { juce::ignoreUnused(paramID, value); }
+        // Typed parameter setter, dispatched by EffectChain via its index table (default no-op)
+        virtual void setParameterValue(ultraglitch::params::ParamIndex index, float value) { juce::ignoreUnused(index, value); }
+
+        // Returns true if this effect bound the given parameter (used to build the dispatch table)
+        [[nodiscard]] bool handlesParameter(ultraglitch::params::ParamIndex index) const;
+
+        // Parameter values this effect generated on the audio thread (e.g. chaos). currentValues
+        // holds what the chain last applied per parameter; EffectChain applies changes.applyMask
+        // to the owning effects, queues changes.publishMask for the host and re-reads the host
+        // value for changes.revertMask. Called even while disabled. Default: none.
+        virtual void collectParameterChanges(const std::array<float, ultraglitch::params::NUM_PARAMETERS>& currentValues,
+                                             GeneratedParameterChanges& changes)
+        {
+            juce::ignoreUnused(currentValues, changes);
+        }
+
+        // Reads a bound ParameterHandle and applies it via setParameterValue(); returns false
+        // (value untouched) if unbound. EffectChain only pulls indices flagged dirty.
+        bool pullParameter(ultraglitch::params::ParamIndex index, float& appliedValue);
         
     protected:
+        // Resolves a parameter once (normally from the derived constructor).
+        // pluginParameters may be nullptr, in which case the index is still
+        // registered for dispatch but nothing is pulled.
+        void bindParameter(const PluginParameters* pluginParameters, ultraglitch::params::ParamIndex index);
+
+        // Binds every parameter other binds (wrappers that forward setParameterValue() to it)
+        void bindParametersOf(const EffectBase& other);
+
+        // Scratch for buffers that only live for one process() call; nullptr outside a chain
+        [[nodiscard]] ScratchArena* getScratchArena() const;
+
         std::atomic<bool> enabled{false};
         std::atomic<float> dryWetMix{1.0f};
         double currentSampleRate{44100.0};
         int currentBlockSize{512};
+
+    private:
+        static constexpr int MAX_BOUND_PARAMETERS = 8;
+        std::array<ParameterHandle, MAX_BOUND_PARAMETERS> parameterHandles_{};
+        int numParameterHandles_ = 0;
+
+        ParameterSmoother mixSmoother_;
+        ScratchArena* scratchArena_ = nullptr;
+        int numChannels_ = 2; // Until the chain says otherwise
+        bool doublePrecision_ = false;
+        bool nonRealtime_ = false;
+        int oversamplingFactor_ = 1;
+    };
+
+    /**
+        One State<float> and one State<double>, for effect state that holds samples (delay
+        lines, capture buffers). process() picks its own with get<SampleType>(); prepare()
+        sizes the one isPreparedFor() and shrinks the other, so only one holds memory.
+    */
+    template <template <typename> class State>
+    class PrecisionStates
+    {
+    public:
+        template <typename SampleType>
+        State<SampleType>& get() { return std::get<State<SampleType>>(states_); }
+
+        template <typename SampleType>
+        const State<SampleType>& get() const { return std::get<State<SampleType>>(states_); }
+
+    private:
+        std::tuple<State<float>, State<double>> states_;
     };
-}
\ No newline at end of file
+}
@@ -1,14 +1,61 @@
 #include "EffectChain.h"
 #include <algorithm>
 #include <cassert>
+#include <limits>
 #include <juce_audio_basics/juce_audio_basics.h>
 #include "../Common/ParameterIDs.h" // Needed for parameter IDs
 #include "../Common/DSPUtils.h" // Needed for ultraglitch::dsp::clamp and mix (though mix is not used directly yet here)
+#include "../Parameters/PluginParameters.h"
+#include "../Parameters/ParameterRegistry.h"
 
 namespace ultraglitch::dsp
 {
 
-EffectChain::EffectChain() = default;
+namespace
+{
+    // Tail lengths saturate at std::numeric_limits<int>::max() ("forever")
+    int addTailSamples(int total, int tailSamples)
+    {
+        return total + juce::jmin(tailSamples, std::numeric_limits<int>::max() - total);
+    }
+
+    // Smoother ramps are float; the double path widens them sample by sample
+    void multiplyByRamp(float* samples, const float* ramp, int numSamples)
+    {
+        juce::FloatVectorOperations::multiply(samples, ramp, numSamples);
+    }
+
+    void multiplyByRamp(double* samples, const float* ramp, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            samples[i] *= static_cast<double>(ramp[i]);
+    }
+
+    // wet becomes dry + mix * (wet - dry): three vector passes, no per-sample branching
+    template <typename SampleType>
+    void blendDryWet(SampleType* wet, const SampleType* dry, const float* mixRamp, float mix, int numSamples)
+    {
+        juce::FloatVectorOperations::subtract(wet, dry, numSamples);
+
+        if (mixRamp != nullptr)
+            multiplyByRamp(wet, mixRamp, numSamples);
+        else
+            juce::FloatVectorOperations::multiply(wet, static_cast<SampleType>(mix), numSamples);
+
+        juce::FloatVectorOperations::add(wet, dry, numSamples);
+    }
+}
+
+const juce::Identifier EffectChain::ROUTING_STATE_TYPE { "Routing" };
+
+EffectChain::EffectChain()
+{
+    for (const auto& spec : ultraglitch::params::PARAMETER_REGISTRY)
+        currentValues_[static_cast<size_t>(spec.index)] = spec.defaultValue;
+
+    publishOrder({});
+    acquirePublishedOrder();
+}
 
 EffectChain::~EffectChain() = default;
 
@@ -16,15 +63,16 @@ void EffectChain::addEffect(std::unique_ptr<ultraglitch::dsp::EffectBase> effect
 {
     EffectSlot slot;
     slot.effect = std::move(effect);
+    slot.effect->setScratchArena(&scratchArenas_[0]);
+    slot.bypassFadePosition = slot.effect->isEnabled() ? bypassFadeSamples_ : 0;
     
     effects_.push_back(std::move(slot));
     rebuildProcessingOrder();
+    rebuildParameterDispatch();
     
     // Prepare the effect if we already have sample rate info
     if (sampleRate_ > 0 && samplesPerBlock_ > 0)
-    {
-        effects_.back().effect->prepare(sampleRate_, samplesPerBlock_);
-    }
+        prepareEffect(effects_.back());
 }
 
 void EffectChain::removeEffect(int index)
@@ -33,13 +81,15 @@ void EffectChain::removeEffect(int index)
     {
         effects_.erase(effects_.begin() + static_cast<ptrdiff_t>(index));
         rebuildProcessingOrder();
+        rebuildParameterDispatch();
     }
 }
 
 void EffectChain::clearEffects()
 {
     effects_.clear();
-    processingOrder_.clear();
+    rebuildProcessingOrder();
+    parameterDispatch_.fill(nullptr);
 }
 
 void EffectChain::bypassEffect(int index, bool shouldBypass)
@@ -64,7 +114,7 @@ void EffectChain::setEffectEnabled(int index, bool enabled)
     if (index >= 0 && index < static_cast<int>(effects_.size()))
     {
         effects_[static_cast<size_t>(index)].effect->setEnabled(enabled);
-        // No need to rebuild — processingOrder_ always contains all effects;
+        // No need to rebuild — the processing order always contains all effects;
         // enabled/disabled check happens in process()
     }
 }
@@ -78,55 +128,211 @@ bool EffectChain::isEffectEnabled(int index) const
     return false;
 }
 
-void EffectChain::setParameterValue(const juce::String& paramID, float value)
+void EffectChain::bindGlobalParameters(const PluginParameters* pluginParameters)
 {
-    if (paramID == ultraglitch::params::Global_OutputGain)
-    {
-        setGlobalMix(value); // This setter handles clamping
-    }
-    else if (paramID == ultraglitch::params::Global_ChaosMode)
+    globalGainHandle_ = pluginParameters != nullptr
+        ? pluginParameters->get_parameter_handle(ultraglitch::params::ParamIndex::Global_Gain)
+        : ParameterHandle();
+    limiterCeilingHandle_ = pluginParameters != nullptr
+        ? pluginParameters->get_parameter_handle(ultraglitch::params::ParamIndex::Limiter_Ceiling)
+        : ParameterHandle();
+}
+
+void EffectChain::setLimiterCeiling(float ceilingDb)
+{
+    limiterCeilingDb_ = ceilingDb;
+    limiters_.get<float>().setCeilingDecibels(ceilingDb);
+    limiters_.get<double>().setCeilingDecibels(ceilingDb);
+}
+
+void EffectChain::updateParameters(ultraglitch::params::ParamMask dirtyMask)
+{
+    using ultraglitch::params::ParamIndex;
+
+    baseChangedMask_ |= dirtyMask;
+
+    // Lowest set bit first; at most NUM_PARAMETERS iterations, usually none
+    for (; dirtyMask != 0; dirtyMask &= dirtyMask - 1)
     {
-        // This parameter controls the enabled state of the ChaosController.
-        // It needs to be routed specifically to the ChaosController effect.
-        for (auto& slot : effects_)
+        const auto index = ultraglitch::params::lowest_set_index(dirtyMask);
+
+        auto& currentValue = currentValues_[static_cast<size_t>(index)];
+
+        if (index == ParamIndex::Global_Gain)
         {
-            if (slot.effect && slot.effect->getName() == "ChaosController")
+            if (globalGainHandle_.isBound())
             {
-                slot.effect->setParameterValue(paramID, value);
-                // Note: ChaosController's setParameterValue should handle its own enabled state.
-                break;
+                currentValue = globalGainHandle_.load();
+                setGlobalMix(currentValue);
             }
         }
-    }
-    else
-    {
-        // Route to individual effects. Each effect's setParameterValue will check if the paramID is relevant to it.
-        for (auto& slot : effects_)
+        else if (index == ParamIndex::Limiter_Ceiling)
         {
-            if (slot.effect)
+            if (limiterCeilingHandle_.isBound())
             {
-                slot.effect->setParameterValue(paramID, value);
+                currentValue = limiterCeilingHandle_.load();
+                setLimiterCeiling(currentValue);
             }
         }
+        else if (auto* owner = parameterDispatch_[static_cast<size_t>(index)])
+        {
+            owner->pullParameter(index, currentValue);
+        }
+    }
+}
+
+void EffectChain::setParameterValue(ultraglitch::params::ParamIndex index, float value)
+{
+    currentValues_[static_cast<size_t>(index)] = value;
+    baseChangedMask_ |= ultraglitch::params::to_mask(index);
+
+    if (index == ultraglitch::params::ParamIndex::Global_Gain)
+    {
+        setGlobalMix(value); // This setter handles clamping
+        return;
+    }
+
+    if (index == ultraglitch::params::ParamIndex::Limiter_Ceiling)
+    {
+        setLimiterCeiling(value);
+        return;
+    }
+
+    // Global_ChaosMode is owned by the ChaosController like any other parameter
+    if (auto* owner = parameterDispatch_[static_cast<size_t>(index)])
+        owner->setParameterValue(index, value);
+}
+
+int EffectChain::popGeneratedParameterChanges(ParameterChange* dest, int maxChanges)
+{
+    return generatedChanges_.pop(dest, maxChanges);
+}
+
+void EffectChain::applyGeneratedParameterChanges()
+{
+    // Disabled effects are asked too: chaos hands back its internal values when switched off
+    for (auto effectIndex : getActiveOrder())
+    {
+        auto& slot = effects_[static_cast<size_t>(effectIndex)];
+
+        if (!slot.effect)
+            continue;
+
+        auto& changes = pendingGeneratedChanges_;
+        changes.applyMask = 0;
+        changes.publishMask = 0;
+        changes.revertMask = 0;
+        changes.orderRequest = GeneratedParameterChanges::OrderRequest::None;
+
+        slot.effect->collectParameterChanges(currentValues_, changes);
+
+        if (changes.revertMask != 0)
+            updateParameters(changes.revertMask);
+
+        // Order requests take effect behind the reorder fade (see updateOrderFade())
+        if (changes.orderRequest == GeneratedParameterChanges::OrderRequest::Shuffle)
+        {
+            hasPendingShuffle_ = true;
+            hasPendingRestore_ = false;
+            pendingShuffleSeed_ = changes.orderSeed;
+        }
+        else if (changes.orderRequest == GeneratedParameterChanges::OrderRequest::Restore)
+        {
+            hasPendingRestore_ = useShuffledOrder_ || hasPendingShuffle_;
+            hasPendingShuffle_ = false;
+        }
+
+        for (auto bits = changes.applyMask; bits != 0; bits &= bits - 1)
+        {
+            const auto index = ultraglitch::params::lowest_set_index(bits);
+            setParameterValue(index, changes.applyValues[static_cast<size_t>(index)]);
+        }
+
+        for (auto bits = changes.publishMask; bits != 0; bits &= bits - 1)
+        {
+            const auto index = ultraglitch::params::lowest_set_index(bits);
+            generatedChanges_.push(index, changes.publishValues[static_cast<size_t>(index)]); // Dropped if full; only the host view lags
+        }
     }
 }
 
-void EffectChain::prepareToPlay(double sampleRate, int samplesPerBlock)
+void EffectChain::applyModulation()
 {
+    modulationMatrix_.applyPendingCommands();
+
+    if (!modulationMatrix_.isActive())
+    {
+        baseChangedMask_ = 0;
+        return;
+    }
+
+    // Destinations whose base was just applied raw are re-modulated even if the result didn't change
+    const auto modulatedMask = modulationMatrix_.computeModulatedValues(currentValues_, modulatedValues_, baseChangedMask_);
+    baseChangedMask_ = 0;
+
+    // Straight to the DSP: currentValues_ keeps the unmodulated base
+    for (auto bits = modulatedMask; bits != 0; bits &= bits - 1)
+    {
+        const auto index = ultraglitch::params::lowest_set_index(bits);
+        const float value = modulatedValues_[static_cast<size_t>(index)];
+
+        if (index == ultraglitch::params::ParamIndex::Global_Gain)
+            setGlobalMix(value);
+        else if (auto* owner = parameterDispatch_[static_cast<size_t>(index)])
+            owner->setParameterValue(index, value);
+    }
+}
+
+void EffectChain::prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels, bool doublePrecision)
+{
+    juce::ignoreUnused(samplesPerBlock); // Host block size: any, process() works in internal blocks
     sampleRate_ = sampleRate;
-    samplesPerBlock_ = samplesPerBlock;
+    samplesPerBlock_ = ultraglitch::config::INTERNAL_BLOCK_SIZE;
+    numChannels_ = juce::jlimit(1, ultraglitch::config::MAX_NUM_CHANNELS, numChannels);
+    doublePrecision_ = doublePrecision;
     
-    // Set up processing buffer size dynamically based on maxBlockSize
-    processingBuffer_.setSize(2, samplesPerBlock); // Assuming stereo for now
-    processingBuffer_.clear();
+    gainSmoother_.prepare(sampleRate, samplesPerBlock_);
+    modulationMatrix_.prepare(sampleRate);
+    for (auto& arena : scratchArenas_)
+        arena.prepare(numChannels_, samplesPerBlock_, MAX_SCRATCH_BUFFERS);
+
+    // Playback is stopped: adopt the latest order without fading
+    orderFadeSamples_ = juce::jmax(1, static_cast<int>(sampleRate * ultraglitch::config::ORDER_CHANGE_FADE_MS * 0.001));
+    bypassFadeSamples_ = juce::jmax(1, static_cast<int>(sampleRate * ultraglitch::config::BYPASS_FADE_MS * 0.001));
+    acquirePublishedOrder();
+    useShuffledOrder_ = false;
+    hasPendingShuffle_ = false;
+    hasPendingRestore_ = false;
+    orderFade_ = OrderFade::None;
+
+    rebuildParameterDispatch();
+
+    // Only the precision in use holds a limiter
+    limiters_.get<float>().release();
+    limiters_.get<double>().release();
+
+    if (limiterEnabled_)
+    {
+        if (doublePrecision_)
+            limiters_.get<double>().prepare(numChannels_, sampleRate, samplesPerBlock_);
+        else
+            limiters_.get<float>().prepare(numChannels_, sampleRate, samplesPerBlock_);
+    }
     
     for (auto& slot : effects_)
     {
+        slot.silentInputSamples = 0;
+        slot.needsReset = false; // prepare() resets anyway
+
         if (slot.effect)
         {
-            slot.effect->prepare(sampleRate, samplesPerBlock);
+            slot.bypassFadePosition = slot.effect->isEnabled() ? bypassFadeSamples_ : 0; // Stopped: no fade
+            prepareEffect(slot);
         }
     }
+
+    // Valid before the first process() call (hosts ask right after prepareToPlay)
+    tailSamples_.store(computeTailSamples(), std::memory_order_relaxed);
 }
 
 void EffectChain::releaseResources()
@@ -138,85 +344,437 @@ void EffectChain::releaseResources()
             slot.effect->reset();
         }
     }
-    
-    processingBuffer_.setSize(0, 0);
 }
 
 void EffectChain::process(juce::AudioBuffer<float>& buffer)
 {
-    const int numChannels = buffer.getNumChannels();
-    const int numSamples = buffer.getNumSamples();
+    process(buffer, 0, buffer.getNumSamples());
+}
+
+void EffectChain::process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    processSamples(buffer, startSample, numSamples);
+}
+
+void EffectChain::process(juce::AudioBuffer<double>& buffer)
+{
+    process(buffer, 0, buffer.getNumSamples());
+}
+
+void EffectChain::process(juce::AudioBuffer<double>& buffer, int startSample, int numSamples)
+{
+    processSamples(buffer, startSample, numSamples);
+}
+
+template <typename SampleType>
+void EffectChain::processSamples(juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples)
+{
+    jassert(startSample >= 0 && startSample + numSamples <= buffer.getNumSamples());
     
-    // Ensure processing buffer is the right size (should have been allocated in prepareToPlay)
-    // Use avoidReallocating=true to prevent RT allocation
-    if (processingBuffer_.getNumChannels() != numChannels || 
-        processingBuffer_.getNumSamples() < numSamples)
+    if (numSamples <= 0)
+        return;
+
+    // Effects only hold sample state for the precision prepareToPlay() announced
+    if (std::is_same_v<SampleType, double> != doublePrecision_)
     {
-        processingBuffer_.setSize(numChannels, numSamples, false, false, true);
+        jassertfalse;
+        return;
     }
-    
-    // Copy input to processing buffer (this will be the 'dry' signal for effects with mix)
-    for (int ch = 0; ch < numChannels; ++ch)
+
+    // Effects, smoothers and scratch are prepared for one internal block; longer ranges
+    // (callers other than the processor's sub-block loop) run as a sequence of them
+    if (numSamples > samplesPerBlock_ && samplesPerBlock_ > 0)
     {
-        processingBuffer_.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+        for (int offset = 0; offset < numSamples; offset += samplesPerBlock_)
+            processSamples(buffer, startSample + offset, juce::jmin(samplesPerBlock_, numSamples - offset));
+        return;
     }
+
+    applyGeneratedParameterChanges();
+    applyModulation();
+    updateOrderFade();
+
+    // Sources see the chain input; new values apply from the next process() call
+    modulationMatrix_.process(buffer, startSample, numSamples);
     
-    // Process through chain in specified order
-    for (auto effectIndex : processingOrder_)
+    // Process through the routing in order, in place on the host buffer (parallel branches
+    // other than the first work on lane copies). Effects see a view of exactly the
+    // sub-range; each reads its dry signal from the samples it is about to overwrite.
+    const auto& order = getActiveOrder();
+    juce::uint32 sleepingMask = 0;
+    int chainTailSamples = 0;
+
+    for (int stageIndex = 0; stageIndex < order.numStages; ++stageIndex)
+        processStage(order, order.stages[static_cast<size_t>(stageIndex)], buffer, startSample, numSamples,
+                     sleepingMask, chainTailSamples);
+
+    sleepingEffectsMask_.store(sleepingMask, std::memory_order_relaxed);
+    tailSamples_.store(addTailSamples(chainTailSamples, getLimiterLatencySamples()), std::memory_order_relaxed);
+
+    // Both are plain gains, so the order fade can go first and the output gain last, where
+    // the limiter applies it on its way in
+    applyOrderFade(buffer, startSample, numSamples);
+    applyOutputGain(buffer, startSample, numSamples);
+}
+
+template <typename SampleType>
+void EffectChain::applyOutputGain(juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples)
+{
+    // Global output gain (globalMix_ is now Global_Gain parameter): the smoother's block ramp
+    // while ramping, a constant otherwise
+    const float* gainRamp = gainSmoother_.getNextBlock(numSamples);
+    auto& limiter = limiters_.get<SampleType>();
+
+    if (limiter.isPrepared())
     {
-        auto& slot = effects_[static_cast<size_t>(effectIndex)];
-        
-        if (slot.effect && slot.effect->isEnabled()) // Check if effect is enabled
-        {
-            slot.effect->process(processingBuffer_);
-        }
+        limiter.process(buffer, startSample, numSamples, gainRamp, globalMix_);
+        return;
     }
-    
-    // Apply global output gain (globalMix_ is now Global_Gain parameter)
-    for (int ch = 0; ch < numChannels; ++ch)
+
+    if (gainRamp == nullptr && globalMix_ == 1.0f)
+        return;
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
     {
-        auto* output = buffer.getWritePointer(ch);
-        auto* wet = processingBuffer_.getReadPointer(ch);
-        
-        for (int i = 0; i < numSamples; ++i)
-        {
-            // Apply Global_Gain which is stored in globalMix_
-            output[i] = wet[i] * globalMix_; 
-        }
+        auto* output = buffer.getWritePointer(ch, startSample);
+
+        if (gainRamp != nullptr)
+            multiplyByRamp(output, gainRamp, numSamples);
+        else
+            juce::FloatVectorOperations::multiply(output, static_cast<SampleType>(globalMix_), numSamples);
     }
 }
 
+int EffectChain::getSamplesUntilNextChangePoint() const
+{
+    int samplesUntilChange = std::numeric_limits<int>::max();
+
+    // A reorder switches exactly when its fade-out ends
+    if (orderFade_ == OrderFade::Out)
+        samplesUntilChange = juce::jmax(1, orderFadeSamples_ - orderFadePosition_);
+    else if (orderFade_ == OrderFade::None && isOrderChangePending())
+        samplesUntilChange = orderFadeSamples_;
+
+    for (auto effectIndex : getActiveOrder())
+    {
+        const auto& slot = effects_[static_cast<size_t>(effectIndex)];
+
+        if (slot.effect && slot.effect->isEnabled())
+            samplesUntilChange = juce::jmin(samplesUntilChange, slot.effect->getSamplesUntilNextChangePoint());
+    }
+
+    return juce::jmin(samplesUntilChange, modulationMatrix_.getSamplesUntilNextTick());
+}
+
 void EffectChain::reset()
 {
     for (auto& slot : effects_)
     {
+        slot.needsReset = false;
+
         if (slot.effect)
         {
             slot.effect->reset();
         }
+
+        if (slot.bypassDelay != nullptr)
+        {
+            slot.bypassDelay->get<float>().reset();
+            slot.bypassDelay->get<double>().reset();
+        }
     }
-    
-    processingBuffer_.clear();
+
+    limiters_.get<float>().reset();
+    limiters_.get<double>().reset();
+    modulationMatrix_.reset();
 }
 
 void EffectChain::setProcessingOrder(const std::vector<int>& order)
 {
-    processingOrder_ = order;
-    
-    // Validate order indices
-    for (int index : processingOrder_)
+    std::vector<RoutingStage> stages;
+    stages.reserve(order.size());
+
+    for (int index : order)
+        stages.push_back({ RoutingBranch{ { index }, 1.0f } });
+
+    setRouting(stages);
+}
+
+std::vector<int> EffectChain::getProcessingOrder() const
+{
+    const auto* order = publishedOrder_.load();
+    return std::vector<int>(order->begin(), order->end());
+}
+
+void EffectChain::setRouting(const std::vector<RoutingStage>& stages)
+{
+    if (stages.empty())
     {
-        if (index < 0 || index >= static_cast<int>(effects_.size()))
+        rebuildProcessingOrder();
+        return;
+    }
+
+    OrderSnapshot snapshot;
+    std::vector<bool> used(effects_.size(), false);
+
+    // Validate: known effects, each at most once, no empty stage or branch, within the limits
+    for (const auto& stage : stages)
+    {
+        if (stage.empty() || static_cast<int>(stage.size()) > ultraglitch::config::MAX_PARALLEL_BRANCHES
+            || snapshot.numStages >= ultraglitch::config::MAX_EFFECTS_IN_CHAIN)
         {
-            rebuildProcessingOrder(); // Revert to default if order is invalid
+            rebuildProcessingOrder(); // Revert to default if routing is invalid
             return;
         }
+
+        auto& snapshotStage = snapshot.stages[static_cast<size_t>(snapshot.numStages++)];
+        snapshotStage.firstBranch = snapshot.numBranches;
+
+        for (const auto& branch : stage)
+        {
+            if (branch.effects.empty() || snapshot.numBranches >= ultraglitch::config::MAX_EFFECTS_IN_CHAIN)
+            {
+                rebuildProcessingOrder();
+                return;
+            }
+
+            auto& snapshotBranch = snapshot.branches[static_cast<size_t>(snapshot.numBranches++)];
+            snapshotBranch.first = snapshot.size;
+            snapshotBranch.gain = juce::jlimit(0.0f, 2.0f, branch.gain);
+
+            for (int index : branch.effects)
+            {
+                if (index < 0 || index >= static_cast<int>(effects_.size()) || used[static_cast<size_t>(index)]
+                    || snapshot.size >= ultraglitch::config::MAX_EFFECTS_IN_CHAIN)
+                {
+                    rebuildProcessingOrder();
+                    return;
+                }
+
+                used[static_cast<size_t>(index)] = true;
+                snapshot.indices[static_cast<size_t>(snapshot.size++)] = index;
+                ++snapshotBranch.count;
+            }
+
+            ++snapshotStage.numBranches;
+        }
     }
+
+    publishOrder(snapshot);
 }
 
-std::vector<int> EffectChain::getProcessingOrder() const
+std::vector<EffectChain::RoutingStage> EffectChain::getRouting() const
+{
+    const auto& order = *publishedOrder_.load();
+    std::vector<RoutingStage> stages;
+
+    for (int stageIndex = 0; stageIndex < order.numStages; ++stageIndex)
+    {
+        const auto& stage = order.stages[static_cast<size_t>(stageIndex)];
+        auto& routingStage = stages.emplace_back();
+
+        for (int b = stage.firstBranch; b < stage.firstBranch + stage.numBranches; ++b)
+        {
+            const auto& branch = order.branches[static_cast<size_t>(b)];
+            routingStage.push_back({ std::vector<int>(order.indices.begin() + branch.first,
+                                                      order.indices.begin() + branch.first + branch.count),
+                                     branch.gain });
+        }
+    }
+
+    return stages;
+}
+
+juce::ValueTree EffectChain::createRoutingState() const
+{
+    juce::ValueTree state(ROUTING_STATE_TYPE);
+
+    for (const auto& stage : getRouting())
+    {
+        juce::ValueTree stageTree("Stage");
+
+        for (const auto& branch : stage)
+        {
+            juce::ValueTree branchTree("Branch");
+            branchTree.setProperty("gain", branch.gain, nullptr);
+
+            for (int index : branch.effects)
+            {
+                juce::ValueTree indexTree("Index");
+                indexTree.setProperty("value", index, nullptr);
+                branchTree.appendChild(indexTree, nullptr);
+            }
+
+            stageTree.appendChild(branchTree, nullptr);
+        }
+
+        state.appendChild(stageTree, nullptr);
+    }
+
+    return state;
+}
+
+void EffectChain::restoreRoutingState(const juce::ValueTree& state)
 {
-    return processingOrder_;
+    std::vector<RoutingStage> stages;
+
+    if (state.isValid() && state.hasType(ROUTING_STATE_TYPE))
+    {
+        for (int s = 0; s < state.getNumChildren(); ++s)
+        {
+            const auto stageTree = state.getChild(s);
+            if (!stageTree.hasType("Stage"))
+                continue;
+
+            auto& stage = stages.emplace_back();
+
+            for (int b = 0; b < stageTree.getNumChildren(); ++b)
+            {
+                const auto branchTree = stageTree.getChild(b);
+                if (!branchTree.hasType("Branch"))
+                    continue;
+
+                auto& branch = stage.emplace_back();
+                branch.gain = static_cast<float>(branchTree.getProperty("gain", 1.0f));
+
+                for (int i = 0; i < branchTree.getNumChildren(); ++i)
+                {
+                    const auto indexTree = branchTree.getChild(i);
+                    if (indexTree.hasType("Index"))
+                        branch.effects.push_back(indexTree.getProperty("value", -1));
+                }
+            }
+        }
+    }
+
+    setRouting(stages); // Empty (older sessions) or invalid: serial
+}
+
+void EffectChain::OrderSnapshot::addSerialEffect(int effectIndex)
+{
+    stages[static_cast<size_t>(numStages++)] = { numBranches, 1 };
+    branches[static_cast<size_t>(numBranches++)] = { size, 1, 1.0f };
+    indices[static_cast<size_t>(size++)] = effectIndex;
+}
+
+void EffectChain::publishOrder(const OrderSnapshot& order)
+{
+    // Message thread: the audio thread only ever sees complete snapshots
+    orderSnapshots_.push_back(std::make_unique<OrderSnapshot>(order));
+    publishedOrder_.store(orderSnapshots_.back().get());
+    reclaimRetiredOrders();
+}
+
+void EffectChain::reclaimRetiredOrders()
+{
+    // Seq-cst loads pair with acquirePublishedOrder(): a snapshot the audio thread may
+    // still dereference is either the published one or its hazard pointer
+    const auto* published = publishedOrder_.load();
+    const auto* hazard = hazardOrder_.load();
+
+    orderSnapshots_.erase(std::remove_if(orderSnapshots_.begin(), orderSnapshots_.end(),
+                                         [published, hazard](const std::unique_ptr<OrderSnapshot>& snapshot)
+                                         {
+                                             return snapshot.get() != published && snapshot.get() != hazard;
+                                         }),
+                          orderSnapshots_.end());
+}
+
+void EffectChain::acquirePublishedOrder()
+{
+    // Hazard pointer protocol: announce the snapshot, then confirm it is still the published
+    // one. If the message thread swapped in between, it may already have freed it — retry.
+    const OrderSnapshot* latest = nullptr;
+    do
+    {
+        latest = publishedOrder_.load();
+        hazardOrder_.store(latest);
+    } while (latest != publishedOrder_.load());
+
+    activeOrder_ = latest;
+}
+
+bool EffectChain::isOrderChangePending() const
+{
+    // Pointer comparison only; the new snapshot is not dereferenced before acquirePublishedOrder()
+    return publishedOrder_.load(std::memory_order_acquire) != activeOrder_ || hasPendingShuffle_ || hasPendingRestore_;
+}
+
+void EffectChain::updateOrderFade()
+{
+    // Effects are stateful single instances, so the old and new order can't run side by
+    // side for a true crossfade; instead the output dips: fade out, switch, fade in
+    if (orderFade_ == OrderFade::None)
+    {
+        if (!isOrderChangePending())
+            return;
+
+        orderFade_ = OrderFade::Out;
+        orderFadePosition_ = 0;
+    }
+
+    if (orderFade_ != OrderFade::Out || orderFadePosition_ < orderFadeSamples_)
+        return;
+
+    // Faded out: switch. An explicit (user) order replaces any chaos shuffle.
+    if (publishedOrder_.load(std::memory_order_acquire) != activeOrder_)
+    {
+        acquirePublishedOrder();
+        useShuffledOrder_ = false;
+    }
+    else if (hasPendingShuffle_)
+    {
+        shuffledOrder_ = *activeOrder_;
+        juce::Random random(pendingShuffleSeed_);
+
+        for (int i = shuffledOrder_.size - 1; i > 0; --i)
+            std::swap(shuffledOrder_.indices[static_cast<size_t>(i)],
+                      shuffledOrder_.indices[static_cast<size_t>(random.nextInt(i + 1))]);
+
+        useShuffledOrder_ = true;
+    }
+    else
+    {
+        useShuffledOrder_ = false; // Restore
+    }
+
+    hasPendingShuffle_ = false;
+    hasPendingRestore_ = false;
+    orderFade_ = OrderFade::In;
+    orderFadePosition_ = 0;
+}
+
+template <typename SampleType>
+void EffectChain::applyOrderFade(juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples)
+{
+    if (orderFade_ == OrderFade::None)
+        return;
+
+    const int rampSamples = juce::jmin(numSamples, juce::jmax(0, orderFadeSamples_ - orderFadePosition_));
+    const float length = static_cast<float>(orderFadeSamples_);
+    float startGain = static_cast<float>(orderFadePosition_) / length;
+    float endGain = static_cast<float>(orderFadePosition_ + rampSamples) / length;
+
+    if (orderFade_ == OrderFade::Out)
+    {
+        startGain = 1.0f - startGain;
+        endGain = 1.0f - endGain;
+    }
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        if (rampSamples > 0)
+            buffer.applyGainRamp(ch, startSample, rampSamples, startGain, endGain);
+
+        // Past the end of a fade-out (sub-block floor): stay silent until the switch
+        if (orderFade_ == OrderFade::Out && rampSamples < numSamples)
+            buffer.clear(ch, startSample + rampSamples, numSamples - rampSamples);
+    }
+
+    orderFadePosition_ += numSamples;
+
+    if (orderFade_ == OrderFade::In && orderFadePosition_ >= orderFadeSamples_)
+        orderFade_ = OrderFade::None;
 }
 
 void EffectChain::setGlobalMix(float gain)
@@ -224,6 +782,7 @@ void EffectChain::setGlobalMix(float gain)
     // globalMix_ now represents the Global_Gain parameter (linear 0.0-2.0, default 1.0)
     // The name "GlobalMix" might be confusing; it's actually output gain.
     globalMix_ = ultraglitch::dsp::clamp(gain, 0.0f, 2.0f);
+    gainSmoother_.setTargetValue(globalMix_);
 }
 
 float EffectChain::getGlobalMix() const
@@ -245,6 +804,384 @@ ultraglitch::dsp::EffectBase* EffectChain::getEffect(int index) const
     return nullptr;
 }
 
+bool EffectChain::isEffectSleeping(int index) const
+{
+    return index >= 0 && index < 32 && (getSleepingEffectsMask() & (1u << index)) != 0;
+}
+
+juce::uint32 EffectChain::getSleepingEffectsMask() const
+{
+    return sleepingEffectsMask_.load(std::memory_order_relaxed);
+}
+
+double EffectChain::getTailLengthSeconds() const
+{
+    const int tailSamples = tailSamples_.load(std::memory_order_relaxed);
+
+    if (tailSamples == std::numeric_limits<int>::max())
+        return std::numeric_limits<double>::infinity();
+
+    return sampleRate_ > 0.0 ? static_cast<double>(tailSamples) / sampleRate_ : 0.0;
+}
+
+template <typename SampleType>
+void EffectChain::processStage(const OrderSnapshot& order, const OrderSnapshot::Stage& stage,
+                               juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples,
+                               juce::uint32& sleepingMask, int& chainTailSamples)
+{
+    const int numChannels = buffer.getNumChannels();
+    const int numBranches = stage.numBranches;
+
+    // Lane buffers (arena views) live until the branches are summed below
+    std::array<std::optional<ScratchArena::Scope>, ultraglitch::config::MAX_PARALLEL_BRANCHES> laneScopes;
+    std::array<juce::AudioBuffer<SampleType>, ultraglitch::config::MAX_PARALLEL_BRANCHES> laneBuffers;
+
+    for (int b = 0; b < numBranches; ++b)
+    {
+        auto& state = branchStates_[static_cast<size_t>(b)];
+        state = BranchState{};
+        state.order = &order;
+        state.branch = &order.branches[static_cast<size_t>(stage.firstBranch + b)];
+        state.numSamples = numSamples;
+        state.arena = &scratchArenas_[static_cast<size_t>(b)];
+
+        if (b == 0)
+        {
+            state.buffer<SampleType>() = &buffer; // Runs in place; the others copy the input first
+            state.startSample = startSample;
+            continue;
+        }
+
+        auto& laneBuffer = laneBuffers[static_cast<size_t>(b)];
+        laneScopes[static_cast<size_t>(b)].emplace(state.arena);
+        laneBuffer = laneScopes[static_cast<size_t>(b)]->allocate<SampleType>(numChannels, numSamples);
+
+        for (int ch = 0; ch < laneBuffer.getNumChannels(); ++ch)
+            laneBuffer.copyFrom(ch, 0, buffer, ch, startSample, numSamples);
+
+        state.buffer<SampleType>() = &laneBuffer;
+        state.branch = laneBuffer.getNumChannels() > 0 ? state.branch : nullptr; // No scratch: branch drops out
+    }
+
+    for (int b = 0; b < numBranches; ++b)
+        processBranch<SampleType>(branchStates_[static_cast<size_t>(b)]);
+
+    // Merge: sum the branches with their gains; the stage's tail is its longest branch's
+    int stageTailSamples = 0;
+
+    for (int b = 0; b < numBranches; ++b)
+    {
+        const auto& state = branchStates_[static_cast<size_t>(b)];
+        sleepingMask |= state.sleepingMask;
+        stageTailSamples = juce::jmax(stageTailSamples, state.tailSamples);
+
+        if (state.branch == nullptr)
+            continue;
+
+        const float gain = state.branch->gain;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            if (b == 0 && gain != 1.0f)
+                buffer.applyGain(ch, startSample, numSamples, gain);
+            else if (b > 0)
+                buffer.addFrom(ch, startSample, laneBuffers[static_cast<size_t>(b)], ch, 0, numSamples, gain);
+        }
+    }
+
+    chainTailSamples = addTailSamples(chainTailSamples, stageTailSamples);
+}
+
+template <typename SampleType>
+void EffectChain::processBranch(BranchState& state)
+{
+    if (state.branch == nullptr)
+        return;
+
+    auto& buffer = *state.buffer<SampleType>();
+    const int startSample = state.startSample;
+    const int numSamples = state.numSamples;
+
+    // An effect whose input has stayed silent past its tail sleeps: its output would be
+    // silent too, so it isn't called. The input is only rescanned after an effect ran.
+    // Enabling/disabling crossfades over BYPASS_FADE_MS; a fully bypassed effect is not
+    // touched at all and gets reset() right before it next runs. runEffect() blends each
+    // effect's wet output with its input at the effect's mix (and skips it at mix 0).
+    // Effects that don't write audio (EffectBase::writesAudio()) just run.
+    bool inputSilent = false;
+    bool inputScanned = false;
+
+    for (int node = state.branch->first; node < state.branch->first + state.branch->count; ++node)
+    {
+        const int effectIndex = state.order->indices[static_cast<size_t>(node)];
+        auto& slot = effects_[static_cast<size_t>(effectIndex)];
+
+        if (!slot.effect)
+            continue;
+
+        const bool enabled = slot.effect->isEnabled();
+
+        if (!enabled && slot.bypassFadePosition == 0) // Fully bypassed
+        {
+            slot.silentInputSamples = 0;
+            if (slot.latencySamples > 0)
+                delayBypassPath(slot, buffer, startSample, numSamples, true);
+            continue;
+        }
+
+        const int tailSamples = slot.effect->getTailSamples();
+        state.tailSamples = addTailSamples(state.tailSamples, tailSamples);
+
+        if (!inputScanned)
+        {
+            inputSilent = isSilent(buffer, startSample, numSamples);
+            inputScanned = true;
+        }
+
+        if (!inputSilent)
+        {
+            slot.silentInputSamples = 0; // Wakes up right here
+        }
+        else
+        {
+            const bool tailDecayed = slot.silentInputSamples >= tailSamples && slot.effect->canSleep();
+            slot.silentInputSamples = addTailSamples(slot.silentInputSamples, numSamples);
+
+            if (tailDecayed)
+            {
+                // Silent either way, so a pending bypass fade has nothing left to do
+                finishBypassFade(slot, enabled);
+                state.sleepingMask |= enabled ? 1u << (effectIndex & 31) : 0u;
+                continue;
+            }
+        }
+
+        slot.effect->setScratchArena(state.arena); // Its lane's arena (earlier lanes still hold their buffers)
+
+        if (!slot.effect->writesAudio())
+        {
+            // Leaves the buffer as it is: nothing to crossfade, and the next effect's input
+            // is still the one scanned above
+            finishBypassFade(slot, enabled);
+            if (enabled)
+                runEffect(slot, *state.arena, buffer, startSample, numSamples);
+            continue;
+        }
+
+        if (slot.bypassFadePosition == (enabled ? bypassFadeSamples_ : 0))
+            runEffect(slot, *state.arena, buffer, startSample, numSamples);
+        else
+            processWithBypassFade(slot, enabled, *state.arena, buffer, startSample, numSamples);
+
+        inputScanned = false;
+    }
+}
+
+int EffectChain::computeTailSamples() const
+{
+    // Same rule as process(): enabled tails add up along a branch, a stage lasts as long as
+    // its longest branch and stages add up
+    const auto& order = getActiveOrder();
+    int chainTailSamples = 0;
+
+    for (int stageIndex = 0; stageIndex < order.numStages; ++stageIndex)
+    {
+        const auto& stage = order.stages[static_cast<size_t>(stageIndex)];
+        int stageTailSamples = 0;
+
+        for (int b = stage.firstBranch; b < stage.firstBranch + stage.numBranches; ++b)
+        {
+            const auto& branch = order.branches[static_cast<size_t>(b)];
+            int branchTailSamples = 0;
+
+            for (int node = branch.first; node < branch.first + branch.count; ++node)
+            {
+                const auto& slot = effects_[static_cast<size_t>(order.indices[static_cast<size_t>(node)])];
+
+                if (slot.effect && slot.effect->isEnabled())
+                    branchTailSamples = addTailSamples(branchTailSamples, slot.effect->getTailSamples());
+            }
+
+            stageTailSamples = juce::jmax(stageTailSamples, branchTailSamples);
+        }
+
+        chainTailSamples = addTailSamples(chainTailSamples, stageTailSamples);
+    }
+
+    return addTailSamples(chainTailSamples, getLimiterLatencySamples());
+}
+
+template <typename SampleType>
+void EffectChain::processWithBypassFade(EffectSlot& slot, bool enabled, ScratchArena& arena,
+                                        juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples)
+{
+    const int numChannels = buffer.getNumChannels();
+
+    // The untouched input, for the crossfade
+    ScratchArena::Scope scratch(&arena);
+    auto dryBuffer = scratch.allocate<SampleType>(numChannels, numSamples);
+
+    if (dryBuffer.getNumChannels() == 0)
+    {
+        finishBypassFade(slot, enabled); // No scratch: switch without a fade
+        if (enabled)
+            runEffect(slot, arena, buffer, startSample, numSamples);
+        else if (slot.latencySamples > 0)
+            delayBypassPath(slot, buffer, startSample, numSamples, true);
+        return;
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        dryBuffer.copyFrom(ch, 0, buffer, ch, startSample, numSamples);
+
+    if (slot.latencySamples > 0) // Lined up with the effect's output
+        delayBypassPath(slot, dryBuffer, 0, numSamples, true);
+
+    runEffect(slot, arena, buffer, startSample, numSamples, &dryBuffer); // Same dry for its mix
+
+    // Wet gain ramps linearly towards 1 (enabling) or 0 (bypassing), then holds there
+    const int target = enabled ? bypassFadeSamples_ : 0;
+    const int fadeSamples = juce::jmin(numSamples, std::abs(target - slot.bypassFadePosition));
+    const int endPosition = slot.bypassFadePosition + (enabled ? fadeSamples : -fadeSamples);
+    const auto startGain = static_cast<SampleType>(slot.bypassFadePosition) / static_cast<SampleType>(bypassFadeSamples_);
+    const auto endGain = static_cast<SampleType>(endPosition) / static_cast<SampleType>(bypassFadeSamples_);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        buffer.applyGainRamp(ch, startSample, fadeSamples, startGain, endGain);
+        buffer.addFromWithRamp(ch, startSample, dryBuffer.getReadPointer(ch), fadeSamples, SampleType(1) - startGain, SampleType(1) - endGain);
+
+        if (!enabled && fadeSamples < numSamples) // Fully bypassed from here on
+            buffer.copyFrom(ch, startSample + fadeSamples, dryBuffer, ch, fadeSamples, numSamples - fadeSamples);
+    }
+
+    slot.bypassFadePosition = endPosition;
+    if (slot.bypassFadePosition == 0)
+        slot.needsReset = true;
+}
+
+template <typename SampleType>
+void EffectChain::runEffect(EffectSlot& slot, ScratchArena& arena, juce::AudioBuffer<SampleType>& buffer,
+                            int startSample, int numSamples, const juce::AudioBuffer<SampleType>* alignedDry)
+{
+    // Effects write wet only; the chain blends in their input at the smoothed mix
+    const float* mixRamp = slot.effect->getMixRamp(numSamples); // nullptr once settled
+    const float mix = slot.effect->getMix();
+    const int numChannels = buffer.getNumChannels();
+
+    // Resting fully dry: the effect isn't run at all (unless it has to keep running, like a
+    // trigger clock) and starts from a clean state when it is next heard
+    if (mixRamp == nullptr && mix <= 0.0f && slot.effect->canSleep())
+    {
+        if (alignedDry != nullptr)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                buffer.copyFrom(ch, startSample, *alignedDry, ch, 0, numSamples);
+        }
+        else if (slot.latencySamples > 0)
+        {
+            delayBypassPath(slot, buffer, startSample, numSamples, true);
+        }
+
+        slot.needsReset = true;
+        return;
+    }
+
+    if (slot.needsReset) // Coming back from bypass (or from fully dry): drop the stale delay/slice state
+    {
+        slot.effect->reset();
+        slot.needsReset = false;
+    }
+
+    if (!slot.effect->writesAudio()) // Output = input at any mix: no dry copy or blend
+    {
+        jassert(slot.latencySamples == 0);
+        slot.effect->processRange(buffer, startSample, numSamples);
+        return;
+    }
+
+    // Fully wet: no dry copy (the bypass path still has to see the input)
+    ScratchArena::Scope scratch(&arena);
+    const bool fullyWet = mixRamp == nullptr && mix >= 1.0f;
+    juce::AudioBuffer<SampleType> dryBuffer;
+
+    if (alignedDry == nullptr && !fullyWet)
+    {
+        dryBuffer = scratch.allocate<SampleType>(numChannels, numSamples);
+
+        if (dryBuffer.getNumChannels() > 0)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                dryBuffer.copyFrom(ch, 0, buffer, ch, startSample, numSamples);
+
+            if (slot.latencySamples > 0) // Lined up with the effect's output
+                delayBypassPath(slot, dryBuffer, 0, numSamples, true);
+
+            alignedDry = &dryBuffer;
+        }
+    }
+
+    if (alignedDry == nullptr && slot.latencySamples > 0) // Keeps the bypass path current
+        delayBypassPath(slot, buffer, startSample, numSamples, false);
+
+    slot.effect->processRange(buffer, startSample, numSamples);
+
+    if (fullyWet || alignedDry == nullptr) // No scratch for the dry copy: wet only
+        return;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        blendDryWet(buffer.getWritePointer(ch, startSample), alignedDry->getReadPointer(ch), mixRamp, mix, numSamples);
+}
+
+template <typename SampleType>
+void EffectChain::delayBypassPath(EffectSlot& slot, juce::AudioBuffer<SampleType>& buffer, int startSample,
+                                  int numSamples, bool replaceWithDelayed)
+{
+    // Every block goes in, whether the effect runs or not, so bypassing mid-stream picks up
+    // exactly where the effect's output is
+    auto& delayLine = slot.bypassDelay->get<SampleType>();
+    const int numChannels = juce::jmin(buffer.getNumChannels(), delayLine.getNumChannels());
+    SampleType* const* channels = buffer.getArrayOfWritePointers();
+    const auto delaySamples = static_cast<float>(slot.latencySamples);
+    std::array<SampleType, ultraglitch::config::MAX_NUM_CHANNELS> frame {};
+
+    for (int i = startSample; i < startSample + numSamples; ++i)
+    {
+        SampleType* writeFrame = delayLine.getWriteFrame();
+        for (int ch = 0; ch < numChannels; ++ch)
+            writeFrame[ch] = channels[ch][i];
+
+        if (replaceWithDelayed)
+        {
+            delayLine.read(delaySamples, frame.data());
+            for (int ch = 0; ch < numChannels; ++ch)
+                channels[ch][i] = frame[static_cast<size_t>(ch)];
+        }
+
+        delayLine.advance();
+    }
+}
+
+void EffectChain::finishBypassFade(EffectSlot& slot, bool enabled)
+{
+    slot.bypassFadePosition = enabled ? bypassFadeSamples_ : 0;
+    if (!enabled)
+        slot.needsReset = true;
+}
+
+template <typename SampleType>
+bool EffectChain::isSilent(const juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples)
+{
+    // One vectorized min/max pass per channel, stopping at the first loud one
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        if (buffer.getMagnitude(ch, startSample, numSamples) >= ultraglitch::config::SILENCE_THRESHOLD)
+            return false;
+    }
+
+    return true;
+}
+
 juce::String EffectChain::getEffectName(int index) const
 {
     if (index >= 0 && index < static_cast<int>(effects_.size()) && effects_[static_cast<size_t>(index)].effect)
@@ -273,16 +1210,20 @@ void EffectChain::saveState(juce::XmlElement& xml) const
     }
     
     auto* orderElement = xml.createNewChildElement("ProcessingOrder");
-    for (int index : processingOrder_)
+    for (int index : *publishedOrder_.load())
     {
         auto* indexElement = orderElement->createNewChildElement("Index");
         indexElement->setAttribute("value", index);
     }
+
+    // Full graph; ProcessingOrder above keeps the flat order for older readers
+    xml.addChildElement(createRoutingState().createXml().release());
 }
 
 void EffectChain::loadState(const juce::XmlElement& xml)
 {
     globalMix_ = static_cast<float>(xml.getDoubleAttribute("GlobalGain", 1.0));
+    gainSmoother_.setCurrentAndTargetValue(globalMix_); // State recall jumps, no ramp
     
     if (auto* effectsElement = xml.getChildByName("Effects"))
     {
@@ -302,7 +1243,11 @@ void EffectChain::loadState(const juce::XmlElement& xml)
         }
     }
 
-    if (auto* orderElement = xml.getChildByName("ProcessingOrder")) // Renamed element
+    if (auto* routingElement = xml.getChildByName(ROUTING_STATE_TYPE))
+    {
+        restoreRoutingState(juce::ValueTree::fromXml(*routingElement));
+    }
+    else if (auto* orderElement = xml.getChildByName("ProcessingOrder")) // Renamed element
     {
         std::vector<int> order;
         for (auto* indexElement : orderElement->getChildIterator())
@@ -322,15 +1267,38 @@ void EffectChain::loadState(const juce::XmlElement& xml)
 
 void EffectChain::rebuildProcessingOrder()
 {
-    processingOrder_.clear();
+    OrderSnapshot order;
     
     // Include ALL effects in chain order — enabled/disabled check happens in process()
-    for (size_t i = 0; i < effects_.size(); ++i)
+    for (size_t i = 0; i < effects_.size() && order.size < ultraglitch::config::MAX_EFFECTS_IN_CHAIN; ++i)
     {
         if (effects_[i].effect)
         {
-            processingOrder_.push_back(static_cast<int>(i));
+            order.addSerialEffect(static_cast<int>(i));
+        }
+    }
+
+    publishOrder(order);
+}
+
+void EffectChain::rebuildParameterDispatch()
+{
+    // Each parameter is owned by at most one effect; first match wins
+    for (int i = 0; i < ultraglitch::params::NUM_PARAMETERS; ++i)
+    {
+        const auto index = static_cast<ultraglitch::params::ParamIndex>(i);
+        ultraglitch::dsp::EffectBase* owner = nullptr;
+
+        for (auto& slot : effects_)
+        {
+            if (slot.effect && slot.effect->handlesParameter(index))
+            {
+                owner = slot.effect.get();
+                break;
+            }
         }
+
+        parameterDispatch_[static_cast<size_t>(i)] = owner;
     }
 }
 
@@ -339,10 +1307,56 @@ void EffectChain::updateEffectPreparation()
     for (auto& slot : effects_)
     {
         if (slot.effect && sampleRate_ > 0 && samplesPerBlock_ > 0)
-        {
-            slot.effect->prepare(sampleRate_, samplesPerBlock_);
-        }
+            prepareEffect(slot);
+    }
+}
+
+void EffectChain::prepareEffect(EffectSlot& slot)
+{
+    slot.effect->prepareParameterSmoothing(sampleRate_, samplesPerBlock_);
+    slot.effect->setNumChannels(numChannels_);
+    slot.effect->setDoublePrecision(doublePrecision_);
+    slot.effect->setNonRealtime(nonRealtime_);
+    slot.effect->prepare(sampleRate_, samplesPerBlock_);
+
+    // A latent effect's bypass path: its input, delayed by the same amount
+    slot.latencySamples = juce::jmax(0, slot.effect->getLatencySamples());
+
+    if (slot.latencySamples == 0)
+    {
+        slot.bypassDelay.reset();
+        return;
     }
+
+    if (slot.bypassDelay == nullptr)
+        slot.bypassDelay = std::make_unique<PrecisionStates<FrameDelayLine>>();
+
+    auto& floatDelay = slot.bypassDelay->get<float>();
+    auto& doubleDelay = slot.bypassDelay->get<double>();
+
+    if (doublePrecision_)
+    {
+        floatDelay.release();
+        doubleDelay.prepare(numChannels_, slot.latencySamples);
+    }
+    else
+    {
+        doubleDelay.release();
+        floatDelay.prepare(numChannels_, slot.latencySamples);
+    }
+}
+
+int EffectChain::getLatencySamples() const
+{
+    int latencySamples = 0;
+    for (const auto& slot : effects_)
+        latencySamples += slot.latencySamples;
+    return latencySamples + getLimiterLatencySamples();
+}
+
+int EffectChain::getLimiterLatencySamples() const
+{
+    return limiters_.get<float>().getLatencySamples() + limiters_.get<double>().getLatencySamples();
 }
 
 } // namespace ultraglitch::dsp
@@ -3,8 +3,18 @@
 
 #include <vector>
 #include <memory>
+#include <array>
+#include <atomic>
 #include <juce_audio_basics/juce_audio_basics.h>
 #include "EffectBase.h" // Points to ultraglitch::dsp::EffectBase
+#include "ParameterChangeQueue.h"
+#include "ModulationMatrix.h"
+#include "ScratchArena.h"
+#include "FrameDelayLine.h"
+#include "TruePeakLimiter.h"
+#include <optional>
+#include <type_traits>
+#include "../Common/PluginConfig.h"
 
 namespace ultraglitch::dsp
 {
@@ -25,20 +35,90 @@ public:
     void setEffectEnabled(int index, bool enabled); // Handled by EffectBase::setEnabled
     bool isEffectEnabled(int index) const; // Handled by EffectBase::isEnabled
     
-    // Parameter management (for individual effects within the chain)
-    // This is the method UltraGlitchAudioProcessor will call
-    void setParameterValue(const juce::String& paramID, float value);
+    // Parameter management. Effects own ParameterHandles for their parameters; the
+    // chain only owns Global_Gain. updateParameters() makes the owning effect pull each
+    // index set in dirtyMask (see PluginParameters::consume_dirty_parameters()), and
+    // setParameterValue() pushes an explicit value — both go through a ParamIndex ->
+    // effect table rebuilt in prepareToPlay() and whenever effects change.
+    void bindGlobalParameters(const PluginParameters* pluginParameters);
+    void updateParameters(ultraglitch::params::ParamMask dirtyMask);
+    void setParameterValue(ultraglitch::params::ParamIndex index, float value);
+
+    // Values effects generated on the audio thread (chaos) are applied at the start of
+    // the next process() call and queued here for the message thread to publish.
+    int popGeneratedParameterChanges(ParameterChange* dest, int maxChanges);
+
+    // Modulation is applied on top of the last applied values (the "base") at the start
+    // of every process() call and never reaches the APVTS. Routes are edited from the
+    // message thread through the matrix itself.
+    ModulationMatrix& getModulationMatrix() { return modulationMatrix_; }
+    const ModulationMatrix& getModulationMatrix() const { return modulationMatrix_; }
     // float getEffectParameter(int effect_index, int parameter_id) const; // Removed, not used
 
-    // Processing
-    void prepareToPlay(double sampleRate, int samplesPerBlock);
+    // Processing. Effects, smoothers and scratch are prepared for config::INTERNAL_BLOCK_SIZE
+    // whatever samplesPerBlock the host announces; process() splits longer ranges into
+    // pieces of that size (the processor already feeds it the fixed sub-block grid).
+    // numChannels (1..config::MAX_NUM_CHANNELS) is what process() buffers will carry, and
+    // doublePrecision picks the process() overload that will be called until the next
+    // prepareToPlay(); effects only hold sample state for that one.
+    void prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels, bool doublePrecision = false);
     void releaseResources();
     void process(juce::AudioBuffer<float>& buffer); // Aligned with EffectBase::process
+    void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples); // Sub-range, in place
+    void process(juce::AudioBuffer<double>& buffer);
+    void process(juce::AudioBuffer<double>& buffer, int startSample, int numSamples);
+    bool isDoublePrecision() const { return doublePrecision_; }
+
+    // Offline rendering (AudioProcessor::isNonRealtime()), passed to the effects at the next
+    // prepareToPlay(); they may pick costlier settings (e.g. OversampledEffect's factor)
+    void setNonRealtime(bool shouldBeNonRealtime) { nonRealtime_ = shouldBeNonRealtime; }
+
+    // True-peak limiter (TruePeakLimiter) as the last stage, with the global gain applied on
+    // its way in. Its lookahead is latency, so it is switched like the precision: at the next
+    // prepareToPlay(), never while processing. The ceiling follows the Limiter_Ceiling
+    // parameter (bindGlobalParameters()) like the global gain.
+    void setLimiterEnabled(bool shouldBeEnabled) { limiterEnabled_ = shouldBeEnabled; }
+    bool isLimiterEnabled() const { return limiterEnabled_; }
+    float getLimiterCeilingDecibels() const { return limiterCeilingDb_; } // Audio thread
+
+    // The effects' latencies summed (EffectBase::getLatencySamples()), for the host; fixed
+    // from one prepareToPlay() to the next. A bypassed effect with latency delays its input
+    // by as much instead, so the total holds whatever is enabled. Exact for serial routing:
+    // parallel branches with different latencies are not aligned against each other.
+    // Includes the output limiter's lookahead when it is enabled.
+    int getLatencySamples() const;
+    int getSamplesUntilNextChangePoint() const; // Nearest internal change point over enabled effects and modulation ticks
     void reset();
     
-    // Chain configuration
-    void setProcessingOrder(const std::vector<int>& order);
-    std::vector<int> getProcessingOrder() const;
+    // Chain configuration. The order is published as an immutable snapshot (RCU): the
+    // message thread swaps in a new one through an atomic pointer and the audio thread
+    // switches to it behind a short fade-out/fade-in, without locks or allocation.
+    // Retired snapshots are freed on the message thread once the audio thread no longer
+    // holds them (hazard pointer) — setProcessingOrder() and reclaimRetiredOrders() do that.
+    void setProcessingOrder(const std::vector<int>& order); // Plain serial routing
+    std::vector<int> getProcessingOrder() const; // The published (user) order, not a chaos shuffle
+    void reclaimRetiredOrders();
+
+    // Routing graph: stages run one after another. Every branch of a stage starts from the
+    // stage input and runs its effects in series; the branch outputs are summed (each scaled
+    // by its gain) into the stage output. setProcessingOrder() is one single-branch stage per
+    // effect. Each effect may appear once. Branches run one after another on the audio
+    // thread, each on its own lane buffer.
+    struct RoutingBranch
+    {
+        std::vector<int> effects;
+        float gain = 1.0f;
+    };
+    using RoutingStage = std::vector<RoutingBranch>;
+
+    void setRouting(const std::vector<RoutingStage>& stages); // Invalid or empty routing reverts to serial
+    std::vector<RoutingStage> getRouting() const;
+
+    // The published routing as a ValueTree (stages of branches of effect indices), for the
+    // processor's state; restoring an invalid or missing tree reverts to serial. Message thread.
+    [[nodiscard]] juce::ValueTree createRoutingState() const;
+    void restoreRoutingState(const juce::ValueTree& state);
+    static const juce::Identifier ROUTING_STATE_TYPE;
     void setGlobalMix(float mix);
     float getGlobalMix() const;
     
@@ -46,6 +126,17 @@ public:
     int getNumEffects() const;
     ultraglitch::dsp::EffectBase* getEffect(int index) const;
     juce::String getEffectName(int index) const; // Changed to juce::String
+
+    // Effect sleep: an enabled effect whose input has been below config::SILENCE_THRESHOLD
+    // for longer than its tail (EffectBase::getTailSamples()) is skipped until signal returns.
+    // Updated every process() call; safe to read from any thread (instrumentation).
+    bool isEffectSleeping(int index) const;
+    juce::uint32 getSleepingEffectsMask() const; // Bit per effect index
+
+    // How long the output keeps sounding after the input goes silent: the enabled effects'
+    // tails summed (they run in series) for their current parameters, infinity if one
+    // rings forever. Refreshed every process() call; safe to call from any thread.
+    double getTailLengthSeconds() const;
     
     // State management
     void saveState(juce::XmlElement& xml) const;
@@ -55,19 +146,170 @@ private:
     struct EffectSlot
     {
         std::unique_ptr<ultraglitch::dsp::EffectBase> effect;
+        int silentInputSamples = 0; // Audio thread: consecutive silent input, saturating
+        int bypassFadePosition = 0; // Audio thread: 0 = fully bypassed ... bypassFadeSamples_ = fully in
+        bool needsReset = false;    // Audio thread: reset() before the next process() (lazy, after bypass)
+        int latencySamples = 0;     // effect->getLatencySamples() as of the last prepare
+        std::unique_ptr<PrecisionStates<FrameDelayLine>> bypassDelay; // Input delayed by latencySamples (latent effects only)
         // bool enabled = true; // Managed by EffectBase
         // bool bypassed = false; // Managed by EffectBase
     };
     
+    struct OrderSnapshot
+    {
+        struct Branch
+        {
+            int first = 0; // Into indices
+            int count = 0;
+            float gain = 1.0f;
+        };
+
+        struct Stage
+        {
+            int firstBranch = 0;
+            int numBranches = 0;
+        };
+
+        // Every routed effect once, grouped by stage, then branch; iterating the snapshot
+        // visits them all (a chaos shuffle permutes indices and keeps the graph's shape)
+        std::array<int, ultraglitch::config::MAX_EFFECTS_IN_CHAIN> indices{};
+        int size = 0;
+
+        std::array<Branch, ultraglitch::config::MAX_EFFECTS_IN_CHAIN> branches{};
+        int numBranches = 0;
+        std::array<Stage, ultraglitch::config::MAX_EFFECTS_IN_CHAIN> stages{};
+        int numStages = 0;
+
+        const int* begin() const { return indices.data(); }
+        const int* end() const { return indices.data() + size; }
+
+        void addSerialEffect(int effectIndex); // One single-branch stage
+    };
+
+    // One branch's work for the current sub-block
+    struct BranchState
+    {
+        const OrderSnapshot* order = nullptr;
+        const OrderSnapshot::Branch* branch = nullptr;
+        // Host buffer for the first branch, a lane buffer otherwise; only the one of the
+        // chain's precision is set
+        juce::AudioBuffer<float>* floatBuffer = nullptr;
+        juce::AudioBuffer<double>* doubleBuffer = nullptr;
+        int startSample = 0;
+        int numSamples = 0;
+        ScratchArena* arena = nullptr;
+
+        juce::uint32 sleepingMask = 0; // Results
+        int tailSamples = 0;
+
+        template <typename SampleType>
+        juce::AudioBuffer<SampleType>*& buffer()
+        {
+            if constexpr (std::is_same_v<SampleType, double>)
+                return doubleBuffer;
+            else
+                return floatBuffer;
+        }
+    };
+
+    enum class OrderFade { None, Out, In };
+
     std::vector<EffectSlot> effects_;
-    std::vector<int> processingOrder_; // Renamed
+
+    // Processing order (see setProcessingOrder())
+    std::atomic<const OrderSnapshot*> publishedOrder_ { nullptr }; // Latest snapshot, written by the message thread
+    std::atomic<const OrderSnapshot*> hazardOrder_ { nullptr };    // Snapshot the audio thread may be reading
+    std::vector<std::unique_ptr<OrderSnapshot>> orderSnapshots_;   // Message thread: published + retired, not yet freed
+    const OrderSnapshot* activeOrder_ = nullptr; // Audio thread
+    OrderSnapshot shuffledOrder_;                // Audio thread: chaos permutation of *activeOrder_
+    bool useShuffledOrder_ = false;
+    bool hasPendingShuffle_ = false;
+    bool hasPendingRestore_ = false;
+    int pendingShuffleSeed_ = 0;
+    OrderFade orderFade_ = OrderFade::None;
+    int orderFadePosition_ = 0;
+    int orderFadeSamples_ = 1;
+    int bypassFadeSamples_ = 1; // Enable/bypass crossfade length (config::BYPASS_FADE_MS)
     float globalMix_ = 1.0f; // Renamed
+    ParameterSmoother gainSmoother_; // Ramps globalMix_ (Global_Gain) to avoid zipper noise
     double sampleRate_ = 44100.0; // Renamed
-    int samplesPerBlock_ = 512; // Renamed
-    
-    juce::AudioBuffer<float> processingBuffer_; // Renamed
+    int samplesPerBlock_ = ultraglitch::config::INTERNAL_BLOCK_SIZE; // What effects are prepared for (not the host's)
+    int numChannels_ = 2; // Channels effects and scratch are prepared for
+    bool doublePrecision_ = false; // process() overload effects are prepared for
+    bool nonRealtime_ = false; // Passed to effects at prepare
+    bool limiterEnabled_ = false; // Applied at prepare
+    PrecisionStates<TruePeakLimiter> limiters_; // Only the prepared precision's is allocated
+    float limiterCeilingDb_ = ultraglitch::config::LIMITER_CEILING_DB; // Limiter_Ceiling
+
+    ParameterHandle globalGainHandle_;
+    ParameterHandle limiterCeilingHandle_;
+
+    ParameterChangeQueue generatedChanges_;
+    GeneratedParameterChanges pendingGeneratedChanges_; // Scratch, reused every process()
+
+    // Last value applied per parameter (host, GUI or generated); seeded from the registry defaults
+    std::array<float, ultraglitch::params::NUM_PARAMETERS> currentValues_{};
+
+    // Per-block temporaries, one arena per parallel lane (lane 0 serves serial stages).
+    // Effects in a lane run one at a time, so MAX_SCRATCH_BUFFERS buffers of
+    // numChannels_ x samplesPerBlock_ are enough: lane buffer, effect scratch and one dry
+    // copy (shared by a bypass fade and the dry/wet mix).
+    static constexpr int MAX_SCRATCH_BUFFERS = 3;
+    std::array<ScratchArena, ultraglitch::config::MAX_PARALLEL_BRANCHES> scratchArenas_;
+
+    // Parallel branches
+    std::array<BranchState, ultraglitch::config::MAX_PARALLEL_BRANCHES> branchStates_;
+
+    ModulationMatrix modulationMatrix_;
+    std::array<float, ultraglitch::params::NUM_PARAMETERS> modulatedValues_{}; // Scratch, reused every process()
+    ultraglitch::params::ParamMask baseChangedMask_ = 0; // Applied unmodulated since the last applyModulation()
+
+    std::atomic<juce::uint32> sleepingEffectsMask_ { 0 };
+    std::atomic<int> tailSamples_ { 0 }; // std::numeric_limits<int>::max() = unbounded
+
+    // ParamIndex -> owning effect (nullptr for chain-level or unowned parameters)
+    std::array<ultraglitch::dsp::EffectBase*, ultraglitch::params::NUM_PARAMETERS> parameterDispatch_{};
     
     void rebuildProcessingOrder(); // Renamed
+    void publishOrder(const OrderSnapshot& order);
+    void acquirePublishedOrder(); // Audio thread (or while stopped)
+    const OrderSnapshot& getActiveOrder() const { return useShuffledOrder_ ? shuffledOrder_ : *activeOrder_; }
+    bool isOrderChangePending() const;
+    void updateOrderFade();
+    void rebuildParameterDispatch();
+
+    // The processing path, one instantiation per sample type; everything around it
+    // (routing, modulation, parameters, fades' state) is shared
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples);
+    template <typename SampleType>
+    void applyOrderFade(juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples);
+    template <typename SampleType>
+    void applyOutputGain(juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples);
+    int getLimiterLatencySamples() const; // 0 while the limiter is off
+    void setLimiterCeiling(float ceilingDb); // Both precisions' limiters, audio thread
+    template <typename SampleType>
+    void processStage(const OrderSnapshot& order, const OrderSnapshot::Stage& stage, juce::AudioBuffer<SampleType>& buffer,
+                      int startSample, int numSamples, juce::uint32& sleepingMask, int& chainTailSamples);
+    template <typename SampleType>
+    void processBranch(BranchState& state);
+    template <typename SampleType>
+    void processWithBypassFade(EffectSlot& slot, bool enabled, ScratchArena& arena, juce::AudioBuffer<SampleType>& buffer,
+                               int startSample, int numSamples);
+    template <typename SampleType>
+    void runEffect(EffectSlot& slot, ScratchArena& arena, juce::AudioBuffer<SampleType>& buffer, int startSample,
+                   int numSamples, const juce::AudioBuffer<SampleType>* alignedDry = nullptr);
+    template <typename SampleType>
+    void delayBypassPath(EffectSlot& slot, juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples,
+                         bool replaceWithDelayed);
+    template <typename SampleType>
+    static bool isSilent(const juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples);
+
+    int computeTailSamples() const;
+    void finishBypassFade(EffectSlot& slot, bool enabled);
+    void prepareEffect(EffectSlot& slot); // Message thread: the effect and its latency compensation
+    void applyGeneratedParameterChanges();
+    void applyModulation();
     void updateEffectPreparation(); // Renamed
 };
 } // namespace ultraglitch::dsp
@@ -4,100 +4,106 @@
 namespace ultraglitch::dsp
 {
 
-BitCrusher::BitCrusher()
+BitCrusher::BitCrusher(const PluginParameters* pluginParameters)
     : bitDepth_(16.0f),
       sampleRateReductionFactor_(1.0f),
       currentSampleRate_(0.0),
       currentMaxBlockSize_(0),
-      reductionCounter_(0),
-      holdValue_(0.0f)
+      reductionCounter_(0)
 {
     // Initialize base class members
     setEnabled(false); // Start disabled
     setMix(1.0f);      // Default to 100% wet
+
+    using ultraglitch::params::ParamIndex;
+    bindParameter(pluginParameters, ParamIndex::BitCrusher_Enabled);
+    bindParameter(pluginParameters, ParamIndex::BitCrusher_BitDepth);
+    bindParameter(pluginParameters, ParamIndex::BitCrusher_SampleRateDiv);
+    bindParameter(pluginParameters, ParamIndex::BitCrusher_Mix);
 }
 
 void BitCrusher::prepare(double sampleRate, int maxBlockSize)
 {
     currentSampleRate_ = sampleRate;
     currentMaxBlockSize_ = maxBlockSize;
-    dryBuffer_.setSize(2, maxBlockSize); // Preallocate for stereo
     reset();
 }
 
-void BitCrusher::process(juce::AudioBuffer<float>& buffer)
+template <typename SampleType>
+void BitCrusher::processSamples(juce::AudioBuffer<SampleType>& buffer)
 {
-    // The EffectChain handles isEnabled() check, so we process if we get here.
-    // However, the individual effects' Mix parameter will be handled here.
-    const int numChannels = buffer.getNumChannels();
+    // The EffectChain handles isEnabled() check and the dry/wet mix; this writes wet only
+    const int numChannels = juce::jmin(buffer.getNumChannels(), ultraglitch::config::MAX_NUM_CHANNELS);
     const int numSamples = buffer.getNumSamples();
 
-    // Resize dryBuffer_ if channel count changes (should not happen in prepareToPlay)
-    // or if maxBlockSize changes (should not happen in processBlock)
-    if (dryBuffer_.getNumChannels() < numChannels || dryBuffer_.getNumSamples() < numSamples)
-    {
-        // Use avoidReallocating=true to prevent RT allocation when possible
-        dryBuffer_.setSize(numChannels, numSamples, false, false, true);
-    }
-
-    // Copy input to preallocated dryBuffer_ for mixing
-    for (int channel = 0; channel < numChannels; ++channel)
-    {
-        dryBuffer_.copyFrom(channel, 0, buffer, channel, 0, numSamples);
-    }
+    // Every channel samples at the same instants: each starts from the shared counter and
+    // keeps its own held value, so channels run independently one after another
+    // Held for the same time when oversampled (the reduction divides the chain's rate)
+    const int reductionFactor = static_cast<int>(sampleRateReductionFactor_) * getOversamplingFactor();
+    int endCounter = reductionCounter_;
 
     for (int channel = 0; channel < numChannels; ++channel)
     {
-        float* channelData = buffer.getWritePointer(channel);
+        SampleType* channelData = buffer.getWritePointer(channel);
+        int counter = reductionCounter_;
+        auto holdValue = static_cast<SampleType>(holdValues_[static_cast<size_t>(channel)]);
         
         for (int sampleIdx = 0; sampleIdx < numSamples; ++sampleIdx)
         {
-            float inputSample = channelData[sampleIdx];
-            float processedSample = inputSample; // Start with input_sample for processing
-
-            if (reductionCounter_ == 0)
+            if (counter == 0)
             {
-                holdValue_ = applyBitCrushing(inputSample);
+                holdValue = applyBitCrushing(channelData[sampleIdx]);
             }
             
-            processedSample = holdValue_;
-            
             // Increment reduction counter and reset if necessary for sample rate reduction
-            reductionCounter_++;
-            if (reductionCounter_ >= static_cast<int>(sampleRateReductionFactor_))
+            if (++counter >= reductionFactor)
             {
-                reductionCounter_ = 0;
+                counter = 0;
             }
 
-            // Apply dry/wet mix from EffectBase
-            channelData[sampleIdx] = ultraglitch::dsp::mix(dryBuffer_.getSample(channel, sampleIdx), processedSample, getMix());
+            channelData[sampleIdx] = holdValue;
         }
+
+        holdValues_[static_cast<size_t>(channel)] = holdValue;
+        endCounter = counter;
     }
+
+    reductionCounter_ = endCounter;
+}
+
+void BitCrusher::process(juce::AudioBuffer<float>& buffer)
+{
+    processSamples(buffer);
+}
+
+void BitCrusher::process(juce::AudioBuffer<double>& buffer)
+{
+    processSamples(buffer);
 }
 
 void BitCrusher::reset()
 {
     reductionCounter_ = 0;
-    holdValue_ = 0.0f;
+    holdValues_.fill(0.0f);
 }
 
-void BitCrusher::setParameterValue(const juce::String& paramID, float value)
+int BitCrusher::getTailSamples() const
 {
-    if (paramID == ultraglitch::params::BitCrusher_Enabled)
-    {
-        setEnabled(value > 0.5f);
-    }
-    else if (paramID == ultraglitch::params::BitCrusher_BitDepth)
-    {
-        setBitDepth(value);
-    }
-    else if (paramID == ultraglitch::params::BitCrusher_SampleRateDiv)
-    {
-        setSampleRateReduction(value);
-    }
-    else if (paramID == ultraglitch::params::BitCrusher_Mix)
+    // The last held (crushed) sample repeats for one reduction period
+    return static_cast<int>(sampleRateReductionFactor_) * getOversamplingFactor();
+}
+
+void BitCrusher::setParameterValue(ultraglitch::params::ParamIndex index, float value)
+{
+    using ultraglitch::params::ParamIndex;
+
+    switch (index)
     {
-        setMix(value); // Param is 0..1, pass directly
+        case ParamIndex::BitCrusher_Enabled:       setEnabled(value > 0.5f); break;
+        case ParamIndex::BitCrusher_BitDepth:      setBitDepth(value); break;
+        case ParamIndex::BitCrusher_SampleRateDiv: setSampleRateReduction(value); break;
+        case ParamIndex::BitCrusher_Mix:           setMix(value); break; // Param is 0..1, pass directly
+        default: break;
     }
 }
 
@@ -113,7 +119,8 @@ void BitCrusher::setSampleRateReduction(float reductionFactor)
     updateInternalState();
 }
 
-float BitCrusher::applyBitCrushing(float sample)
+template <typename SampleType>
+SampleType BitCrusher::applyBitCrushing(SampleType sample) const
 {
     if (bitDepth_ >= 16.0f) // No bit crushing if depth is max or higher
     {
@@ -121,8 +128,8 @@ float BitCrusher::applyBitCrushing(float sample)
     }
     
     // Scale factor to effectively quantize the sample
-    const float maxQuantizedValue = std::pow(2.0f, bitDepth_); // Number of discrete levels
-    const float quantizedSample = std::floor(sample * maxQuantizedValue) / maxQuantizedValue;
+    const auto maxQuantizedValue = static_cast<SampleType>(std::pow(2.0f, bitDepth_)); // Number of discrete levels
+    const SampleType quantizedSample = std::floor(sample * maxQuantizedValue) / maxQuantizedValue;
     
     return quantizedSample;
 }
@@ -3,21 +3,26 @@
 #include "../EffectBase.h" // Points to ultraglitch::dsp::EffectBase
 #include "../../Common/DSPUtils.h" // Points to ultraglitch::dsp::DSPUtils
 #include "../../Common/ParameterIDs.h" // For parameter IDs
+#include "../../Common/PluginConfig.h" // For MAX_NUM_CHANNELS
+#include <array>
 
 namespace ultraglitch::dsp
 {
-class BitCrusher : public ultraglitch::dsp::EffectBase
+class BitCrusher final : public ultraglitch::dsp::EffectBase
 {
 public:
-    BitCrusher();
+    // pluginParameters may be nullptr (effect then keeps its defaults until set explicitly)
+    explicit BitCrusher(const PluginParameters* pluginParameters = nullptr);
     ~BitCrusher() override = default;
 
     void prepare(double sampleRate, int maxBlockSize) override;
     void process(juce::AudioBuffer<float>& buffer) override;
+    void process(juce::AudioBuffer<double>& buffer) override;
     void reset() override;
+    [[nodiscard]] int getTailSamples() const override;
 
     // Parameter setters from PluginParameters/EffectChain
-    void setParameterValue(const juce::String& paramID, float value) override;
+    void setParameterValue(ultraglitch::params::ParamIndex index, float value) override;
 
     // Specific parameter setters (internal, might be called by setParameterValue)
     void setBitDepth(float bits);
@@ -33,11 +38,14 @@ private:
     int currentMaxBlockSize_ = 0;
 
     // Internal DSP state
-    int reductionCounter_ = 0;
-    float holdValue_ = 0.0f;
-    juce::AudioBuffer<float> dryBuffer_; // Preallocated buffer for dry signal
+    int reductionCounter_ = 0; // Shared: all channels sample at the same instants
+    std::array<double, ultraglitch::config::MAX_NUM_CHANNELS> holdValues_ {}; // Per channel (exact for either precision)
 
-    float applyBitCrushing(float sample);
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer);
+
+    template <typename SampleType>
+    SampleType applyBitCrushing(SampleType sample) const;
     void updateInternalState(); // Method to recalculate internal DSP values based on parameters
     
     // JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BitCrusher) // Not needed for derived class unless specific non-copyable requirements
@@ -6,12 +6,18 @@
 namespace ultraglitch::dsp
 {
 
-BufferStutter::BufferStutter()
+BufferStutter::BufferStutter(const PluginParameters* pluginParameters)
     : random_() // Initialize juce::Random
 {
     // Initialize base class members
     setEnabled(false); // Start disabled
     setMix(0.0f);      // Default to 0% wet as per tasq.md
+
+    using ultraglitch::params::ParamIndex;
+    bindParameter(pluginParameters, ParamIndex::BufferStutter_Enabled);
+    bindParameter(pluginParameters, ParamIndex::BufferStutter_Rate);
+    bindParameter(pluginParameters, ParamIndex::BufferStutter_Length);
+    bindParameter(pluginParameters, ParamIndex::BufferStutter_Mix);
 }
 
 void BufferStutter::prepare(double sampleRate, int maxBlockSize)
@@ -20,7 +26,7 @@ void BufferStutter::prepare(double sampleRate, int maxBlockSize)
     if (sampleRate <= 0.0 || sampleRate > 384000.0)
         return;
 
-    if (maxBlockSize <= 0 || maxBlockSize > 8192)
+    if (maxBlockSize <= 0) // Any positive size: the circular buffer is sized by time, not block
         return;
 
     currentSampleRate_ = sampleRate;
@@ -40,15 +46,16 @@ void BufferStutter::prepare(double sampleRate, int maxBlockSize)
 
     bufferDurationSamples_ = safeSize;
 
-    // Use assign instead of resize to force clean reallocation
-    circularBuffer_.assign(bufferDurationSamples_, 0.0f);
-
-    // ---- Preallocate working buffers safely ----
-    dryBuffer_.setSize(2, maxBlockSize, false, false, true);
-    dryBuffer_.clear();
-
-    stutterOutputBuffer_.setSize(2, maxBlockSize, false, false, true);
-    stutterOutputBuffer_.clear();
+    // Use assign instead of resize to force clean reallocation (frame-major: all channels
+    // of one sample adjacent)
+    numChannels_ = getNumChannels();
+    const size_t ringSize = static_cast<size_t>(bufferDurationSamples_) * static_cast<size_t>(numChannels_);
+    auto& floatRing = circularBuffers_.get<float>();
+    auto& doubleRing = circularBuffers_.get<double>();
+    floatRing.assign(isPreparedFor<float>() ? ringSize : 0, 0.0f);
+    doubleRing.assign(isPreparedFor<double>() ? ringSize : 0, 0.0);
+    floatRing.shrink_to_fit(); // Frees whichever precision is not in use
+    doubleRing.shrink_to_fit();
 
     // ---- Reset slice pool safely ----
     for (int i = 0; i < MAX_ACTIVE_SLICES; ++i)
@@ -59,38 +66,38 @@ void BufferStutter::prepare(double sampleRate, int maxBlockSize)
 
     activeSlicesCount_ = 0;
 
+    // ---- Recompute sample-rate dependent trigger/slice lengths ----
+    updateInternalState();
+
     // ---- Reset internal state to prevent stale pointer behaviour ----
     writePosition_ = 0;
 // ----    readPosition_  = 0; ----
 }
 
-void BufferStutter::process(juce::AudioBuffer<float>& buffer)
+template <typename SampleType>
+void BufferStutter::processSamples(juce::AudioBuffer<SampleType>& buffer)
 {
-    const int numChannels = buffer.getNumChannels();
+    const int numChannels = juce::jmin(buffer.getNumChannels(), numChannels_); // As prepared by EffectChain
     const int numSamples = buffer.getNumSamples();
 
-    // Guard: host may deliver blocks larger than maxBlockSize from prepare()
-    if (numSamples > dryBuffer_.getNumSamples() || numChannels > dryBuffer_.getNumChannels())
-    {
-        dryBuffer_.setSize(juce::jmax(numChannels, 2), numSamples, false, false, true);
-        stutterOutputBuffer_.setSize(juce::jmax(numChannels, 2), numSamples, false, false, true);
-    }
+    // buffer is only read (recorded) until the end, where the wet signal replaces it. That
+    // is built as interleaved frames in the chain's scratch arena (cleared, released on
+    // return), matching the circular buffer's layout.
+    ScratchArena::Scope scratch(getScratchArena());
+    SampleType* stutterFrames = scratch.allocateInterleaved<SampleType>(numChannels, numSamples);
+    auto& circularBuffer = circularBuffers_.get<SampleType>();
+    if (stutterFrames == nullptr || circularBuffer.empty())
+        return; // No scratch (not in a prepared EffectChain) or not prepared for this precision: pass through
 
-    // Copy input to dryBuffer_ for mixing later
-    for(int ch = 0; ch < numChannels; ++ch)
-        dryBuffer_.copyFrom(ch, 0, buffer, ch, 0, numSamples);
-    
-    stutterOutputBuffer_.clear(); // Clear wet buffer for current block
+    const SampleType* const* inputChannels = buffer.getArrayOfReadPointers();
 
     for (int sampleIdx = 0; sampleIdx < numSamples; ++sampleIdx)
     {
-        // 1. Record incoming audio to circular buffer (mono sum for simplicity)
-        float monoInput = 0.0f;
-        for(int ch = 0; ch < numChannels; ++ch)
-            monoInput += buffer.getSample(ch, sampleIdx);
-        monoInput /= static_cast<float>(numChannels);
+        // 1. Record incoming audio to circular buffer (one frame, every channel)
+        SampleType* writeFrame = circularBuffer.data() + static_cast<size_t>(writePosition_) * static_cast<size_t>(numChannels_);
+        for (int ch = 0; ch < numChannels; ++ch)
+            writeFrame[ch] = inputChannels[ch][sampleIdx];
 
-        circularBuffer_[writePosition_] = monoInput;
         writePosition_ = (writePosition_ + 1) % bufferDurationSamples_;
 
         // 2. Trigger new slice based on rate
@@ -101,14 +108,16 @@ void BufferStutter::process(juce::AudioBuffer<float>& buffer)
             currentTriggerPhase_ -= triggerIntervalSamples_; // Subtract to maintain phase
         }
 
-        // 3. Advance active slices and sum their output to stutterOutputBuffer_
+        // 3. Advance active slices and sum their output frames into stutterFrames
+        SampleType* outputFrame = stutterFrames + sampleIdx * numChannels;
+
         for (int i = 0; i < activeSlicesCount_; ++i) // Iterate only active slices
         {
             StutterSlice& slice = activeSlicesPool_[i];
             if (slice.isActive)
             {
                 int readPos = (slice.startSample + slice.currentPosition) % bufferDurationSamples_;
-                float sampleValue = circularBuffer_[readPos];
+                const SampleType* readFrame = circularBuffer.data() + static_cast<size_t>(readPos) * static_cast<size_t>(numChannels_);
                 
                 // Apply crossfade envelope at slice boundaries
                 float fadeGain = 1.0f;
@@ -120,11 +129,10 @@ void BufferStutter::process(juce::AudioBuffer<float>& buffer)
                         fadeGain = static_cast<float>(slice.lengthSamples - slice.currentPosition) / static_cast<float>(slice.fadeSamples);
                 }
                 
-                // Add sample to the wet buffer (stereo)
+                // Add the frame to the wet output, all channels at once
+                const auto gain = static_cast<SampleType>(slice.gain * fadeGain);
                 for (int ch = 0; ch < numChannels; ++ch)
-                {
-                    stutterOutputBuffer_.addSample(ch, sampleIdx, sampleValue * slice.gain * fadeGain);
-                }
+                    outputFrame[ch] += readFrame[ch] * gain;
 
                 slice.currentPosition++;
 
@@ -154,26 +162,26 @@ void BufferStutter::process(juce::AudioBuffer<float>& buffer)
 
     } // End of sample loop
 
-    // 4. Mix original dryBuffer_ with processed stutterOutputBuffer_
-    float currentMix = getMix(); // Get mix from EffectBase
-    if (currentMix == 0.0f) return; // Completely dry, no need to mix
+    // 4. The stutter frames are the output (EffectChain mixes in the dry signal)
+    ultraglitch::dsp::deinterleave_channels(stutterFrames, numChannels, numSamples, buffer.getArrayOfWritePointers(), 0);
+}
 
-    for (int channel = 0; channel < numChannels; ++channel)
-    {
-        float* outputChannelData = buffer.getWritePointer(channel);
-        const float* dryChannelData = dryBuffer_.getReadPointer(channel);
-        const float* stutterWetData = stutterOutputBuffer_.getReadPointer(channel);
+void BufferStutter::process(juce::AudioBuffer<float>& buffer)
+{
+    processSamples(buffer);
+}
 
-        for (int sampleIdx = 0; sampleIdx < numSamples; ++sampleIdx)
-        {
-            outputChannelData[sampleIdx] = ultraglitch::dsp::mix(dryChannelData[sampleIdx], stutterWetData[sampleIdx], currentMix);
-        }
-    }
+void BufferStutter::process(juce::AudioBuffer<double>& buffer)
+{
+    processSamples(buffer);
 }
 
 void BufferStutter::reset()
 {
-    std::fill(circularBuffer_.begin(), circularBuffer_.end(), 0.0f);
+    auto& floatRing = circularBuffers_.get<float>();
+    auto& doubleRing = circularBuffers_.get<double>();
+    std::fill(floatRing.begin(), floatRing.end(), 0.0f);
+    std::fill(doubleRing.begin(), doubleRing.end(), 0.0);
     writePosition_ = 0;
     
     // Reset active slices pool
@@ -184,26 +192,26 @@ void BufferStutter::reset()
     activeSlicesCount_ = 0;
 
     currentTriggerPhase_ = 0.0f;
-    stutterOutputBuffer_.clear();
 }
 
-void BufferStutter::setParameterValue(const juce::String& paramID, float value)
+int BufferStutter::getTailSamples() const
 {
-    if (paramID == ultraglitch::params::BufferStutter_Enabled)
-    {
-        setEnabled(value > 0.5f);
-    }
-    else if (paramID == ultraglitch::params::BufferStutter_Rate)
-    {
-        setStutterRate(value);
-    }
-    else if (paramID == ultraglitch::params::BufferStutter_Length)
-    {
-        setStutterLength(value);
-    }
-    else if (paramID == ultraglitch::params::BufferStutter_Mix)
+    // A slice triggered right at the end of the input captured up to one slice length
+    // of it and plays for another; older slices end before that
+    return 2 * juce::jmax(1, juce::jmin(sliceLengthSamples_, bufferDurationSamples_));
+}
+
+void BufferStutter::setParameterValue(ultraglitch::params::ParamIndex index, float value)
+{
+    using ultraglitch::params::ParamIndex;
+
+    switch (index)
     {
-        setMix(value); // Mix parameter is 0-1, so no division by 100
+        case ParamIndex::BufferStutter_Enabled: setEnabled(value > 0.5f); break;
+        case ParamIndex::BufferStutter_Rate:    setStutterRate(value); break;
+        case ParamIndex::BufferStutter_Length:  setStutterLength(value); break;
+        case ParamIndex::BufferStutter_Mix:     setMix(value); break; // Mix parameter is 0-1, so no division by 100
+        default: break;
     }
 }
 
@@ -9,17 +9,20 @@
 
 namespace ultraglitch::dsp
 {
-class BufferStutter : public ultraglitch::dsp::EffectBase {
+class BufferStutter final : public ultraglitch::dsp::EffectBase {
 public:
-    BufferStutter();
+    // pluginParameters may be nullptr (effect then keeps its defaults until set explicitly)
+    explicit BufferStutter(const PluginParameters* pluginParameters = nullptr);
     ~BufferStutter() override = default;
 
     void prepare(double sampleRate, int maxBlockSize) override;
     void process(juce::AudioBuffer<float>& buffer) override;
+    void process(juce::AudioBuffer<double>& buffer) override;
     void reset() override;
+    [[nodiscard]] int getTailSamples() const override;
 
     // Parameter setter from PluginParameters/EffectChain
-    void setParameterValue(const juce::String& paramID, float value) override;
+    void setParameterValue(ultraglitch::params::ParamIndex index, float value) override;
 
     // Specific parameter setters (internal, might be called by setParameterValue)
     void setStutterRate(float rate); // 1-16 divisions
@@ -37,6 +40,12 @@ private:
         int fadeSamples; // Crossfade length at start/end
     };
 
+    template <typename SampleType>
+    using SampleRing = std::vector<SampleType>;
+
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer);
+
     void updateInternalState();
     void triggerNewSlice(); // This needs to be carefully implemented for real-time safety
     void advancePlayback();
@@ -44,7 +53,8 @@ private:
     // void fillOutputBuffer(juce::AudioBuffer<float>& buffer); // Not used in current impl
 
     // Internal state variables
-    std::vector<float> circularBuffer_;
+    PrecisionStates<SampleRing> circularBuffers_; // bufferDurationSamples_ frames of numChannels_ samples
+    int numChannels_ = 0; // Channels per circular buffer frame
     int writePosition_ = 0;
     int bufferSizeSamples_ = 0; // The actual buffer size (capacity)
 
@@ -60,10 +70,6 @@ private:
     
     juce::Random random_; // For randomization if needed
 
-    juce::AudioBuffer<float> dryBuffer_; // Preallocated buffer for dry signal
-    // Internal temporary buffer for stuttered audio playback
-    juce::AudioBuffer<float> stutterOutputBuffer_;
-
     // To manage when a slice should trigger
     double currentSampleRate_ = 0.0;
     int samplesPerBlock_ = 0;
@@ -1,26 +1,32 @@
 #include "ChaosController.h"
 #include "../../Common/DSPUtils.h"
 #include "../../Common/ParameterIDs.h"
-#include "../../Parameters/PluginParameters.h" // Needed for PluginParameters definition
-#include <random> // For std::mt19937
+#include <cmath>
 
 namespace ultraglitch::dsp
 {
 
-ChaosController::ChaosController(PluginParameters* pluginParameters)
-    : pluginParameters_(pluginParameters),
-      randomGenerator_(std::random_device{}()), // Initialize std::mt19937
-      juceRandomGenerator_(juce::Time::currentTimeMillis()) // Initialize juce::Random
+ChaosController::ChaosController(const PluginParameters* pluginParameters)
+    : randomGenerator_(RANDOM_SEED)
 {
     // Initialize base class members
     setEnabled(false); // Start disabled
     setMix(0.0f);      // Chaos controller doesn't process audio, so mix is irrelevant
+
+    using ultraglitch::params::ParamIndex;
+    bindParameter(pluginParameters, ParamIndex::Global_ChaosMode);
+    bindParameter(pluginParameters, ParamIndex::ChaosController_Speed);
+    bindParameter(pluginParameters, ParamIndex::ChaosController_Intensity);
+    bindParameter(pluginParameters, ParamIndex::ChaosController_Slew);
+    bindParameter(pluginParameters, ParamIndex::ChaosController_HostSync);
+    bindParameter(pluginParameters, ParamIndex::ChaosController_Reorder);
 }
 
 void ChaosController::prepare(double sampleRate, int maxBlockSize)
 {
     currentSampleRate_ = sampleRate;
     currentMaxBlockSize_ = maxBlockSize;
+    updateGlideCoefficient();
     
     // Calculate initial update interval based on speed
     setSpeed(speed_); // Call setter to recalculate updateIntervalSamples_
@@ -29,20 +35,46 @@ void ChaosController::prepare(double sampleRate, int maxBlockSize)
 
 void ChaosController::process(juce::AudioBuffer<float>& buffer)
 {
-    juce::ignoreUnused(buffer); // This effect does not process audio directly
+    advance(buffer.getNumSamples()); // This effect does not process audio directly
+}
 
+void ChaosController::process(juce::AudioBuffer<double>& buffer)
+{
+    advance(buffer.getNumSamples());
+}
+
+void ChaosController::advance(int numSamples)
+{
     if (!isEnabled()) // Check if chaos mode is enabled
         return;
 
-    const int numSamples = buffer.getNumSamples();
+    int samplesLeft = numSamples;
     
-    for (int sample = 0; sample < numSamples; ++sample)
+    // Advance in jumps to the next trigger / glide step. processBlock cuts sub-blocks at
+    // getSamplesUntilNextChangePoint(), so both land on the last sample of a sub-block
+    // and EffectChain applies the values from the very next sample on.
+    while (samplesLeft > 0)
     {
-        samplesCounter_++;
+        int step = juce::jmin(samplesLeft, juce::jmax(1, updateIntervalSamples_ - samplesCounter_));
+        if (glidingMask_ != 0)
+            step = juce::jmin(step, MORPH_CONTROL_INTERVAL_SAMPLES - controlCounter_);
+
+        samplesCounter_ += step;
+        samplesLeft -= step;
+
+        if (glidingMask_ != 0)
+        {
+            controlCounter_ += step;
+            if (controlCounter_ >= MORPH_CONTROL_INTERVAL_SAMPLES)
+            {
+                controlCounter_ = 0;
+                advanceGlides();
+            }
+        }
         
         if (samplesCounter_ >= updateIntervalSamples_)
         {
-            shouldTriggerRandomization_.store(true); // Signal randomization is needed
+            randomizeParameters();
             samplesCounter_ = 0;
             // Recalculate interval in case speed changed
             setSpeed(speed_); // This will update updateIntervalSamples_
@@ -50,32 +82,76 @@ void ChaosController::process(juce::AudioBuffer<float>& buffer)
     }
 }
 
+int ChaosController::getSamplesUntilNextChangePoint() const
+{
+    if (!isEnabled())
+        return std::numeric_limits<int>::max();
+
+    // process() fires the trigger on the sample that brings the counter to the interval
+    int samplesUntilChange = juce::jmax(1, updateIntervalSamples_ - samplesCounter_);
+
+    if (glidingMask_ != 0)
+        samplesUntilChange = juce::jmin(samplesUntilChange, MORPH_CONTROL_INTERVAL_SAMPLES - controlCounter_);
+
+    return samplesUntilChange;
+}
+
 void ChaosController::reset()
+{
+    restartSequence();
+}
+
+void ChaosController::restartSequence()
 {
     samplesCounter_ = 0;
-    shouldTriggerRandomization_.store(false); // Clear any pending randomization trigger
+    pendingMask_ = 0; // Drop values not yet applied
+    glidingMask_ = 0;
+    glideStepMask_ = 0;
+    controlCounter_ = 0;
+    requestOrderRestore(); // Start from the user's chain order
+    randomGenerator_.setSeed(RANDOM_SEED); // Same sequence on every playback/bounce
 }
 
-void ChaosController::setParameterValue(const juce::String& paramID, float value)
+void ChaosController::setParameterValue(ultraglitch::params::ParamIndex index, float value)
 {
-    if (paramID == ultraglitch::params::Global_ChaosMode)
+    using ultraglitch::params::ParamIndex;
+
+    switch (index)
     {
-        bool wasEnabled = isEnabled();
-        setEnabled(value > 0.5f);
-        if (wasEnabled && !isEnabled())
+        case ParamIndex::Global_ChaosMode:
         {
-            // Chaos disabled — stop any pending triggers and reset counter
-            samplesCounter_ = 0;
-            shouldTriggerRandomization_.store(false);
+            bool wasEnabled = isEnabled();
+            setEnabled(value > 0.5f);
+            if (wasEnabled && !isEnabled())
+            {
+                // Chaos disabled — drop pending values, freeze glides, reset counter
+                samplesCounter_ = 0;
+                pendingMask_ = 0;
+                glidingMask_ = 0;
+                glideStepMask_ = 0;
+                revertMask_ |= internalMask_; // Internal-only values go back to what the host shows
+                internalMask_ = 0;
+                requestOrderRestore(); // Back to the user's chain order
+            }
+            break;
         }
-    }
-    else if (paramID == ultraglitch::params::ChaosController_Speed)
-    {
-        setSpeed(value);
-    }
-    else if (paramID == ultraglitch::params::ChaosController_Intensity)
-    {
-        setIntensity(value / 100.0f); // Param is 0..100%, DSP expects 0..1
+        case ParamIndex::ChaosController_Speed:
+            setSpeed(value);
+            break;
+        case ParamIndex::ChaosController_Intensity:
+            setIntensity(value / 100.0f); // Param is 0..100%, DSP expects 0..1
+            break;
+        case ParamIndex::ChaosController_Slew:
+            setSlew(value);
+            break;
+        case ParamIndex::ChaosController_HostSync:
+            setHostSync(value > 0.5f);
+            break;
+        case ParamIndex::ChaosController_Reorder:
+            setReorder(value > 0.5f);
+            break;
+        default:
+            break;
     }
 }
 
@@ -96,32 +172,201 @@ void ChaosController::setIntensity(float intensity)
     intensity_ = ultraglitch::dsp::clamp(intensity, 0.0f, 1.0f); // 0-1 range
 }
 
-void ChaosController::randomizeParameters()
+void ChaosController::setSlew(float slewMs)
 {
-    if (!pluginParameters_)
+    slewMs_ = ultraglitch::dsp::clamp(slewMs, 0.0f, 2000.0f);
+    updateGlideCoefficient();
+}
+
+void ChaosController::setHostSync(bool shouldSync)
+{
+    if (shouldSync && !hostSync_)
+    {
+        // The host never saw the internal values; return to its view (this also cancels their glides)
+        revertMask_ |= internalMask_;
+        internalMask_ = 0;
+    }
+
+    hostSync_ = shouldSync;
+}
+
+void ChaosController::setReorder(bool shouldReorder)
+{
+    if (!shouldReorder && reorder_)
+        requestOrderRestore();
+
+    reorder_ = shouldReorder;
+}
+
+void ChaosController::requestOrderRestore()
+{
+    if (!orderShuffled_)
         return;
 
-    const auto& allParameters = pluginParameters_->get_parameter_definitions();
+    pendingOrderRequest_ = GeneratedParameterChanges::OrderRequest::Restore;
+    orderShuffled_ = false;
+}
+
+void ChaosController::updateGlideCoefficient()
+{
+    if (slewMs_ <= 0.0f || currentSampleRate_ <= 0.0)
+    {
+        glideCoefficient_ = 1.0f; // Next glide step lands on the target
+        return;
+    }
+
+    // Time constant such that 99% of the distance is covered after slewMs_
+    const double timeConstantSamples = slewMs_ * 0.001 * currentSampleRate_ / std::log(100.0);
+    glideCoefficient_ = static_cast<float>(1.0 - std::exp(-MORPH_CONTROL_INTERVAL_SAMPLES / timeConstantSamples));
+}
+
+void ChaosController::advanceGlides()
+{
+    constexpr int numLanes = ultraglitch::params::NUM_PARAMETERS;
+
+    // value += (target - value) * coefficient, for every lane at once
+    juce::FloatVectorOperations::subtract(glideScratch_.data(), glideTargets_.data(), glideValues_.data(), numLanes);
+    juce::FloatVectorOperations::addWithMultiply(glideValues_.data(), glideScratch_.data(), glideCoefficient_, numLanes);
+
+    glideStepMask_ |= glidingMask_;
 
-    for (const auto& paramDef : allParameters)
+    // Snap lanes that are close enough (one-pole never quite arrives)
+    for (auto bits = glidingMask_; bits != 0; bits &= bits - 1)
     {
-        // Don't randomize ChaosController's own parameters or global gain
-        if (paramDef.id == ultraglitch::params::Global_ChaosMode ||
-            paramDef.id == ultraglitch::params::ChaosController_Speed ||
-            paramDef.id == ultraglitch::params::ChaosController_Intensity ||
-            paramDef.id == ultraglitch::params::Global_OutputGain) // Global_Gain is now Global_OutputGain
+        const auto index = ultraglitch::params::lowest_set_index(bits);
+        const auto i = static_cast<size_t>(index);
+        const auto& spec = ultraglitch::params::get_parameter_spec(index);
+
+        if (std::abs(glideTargets_[i] - glideValues_[i]) <= 0.001f * (spec.maxValue - spec.minValue))
+        {
+            glideValues_[i] = glideTargets_[i];
+            glidingMask_ &= ~ultraglitch::params::to_mask(index);
+        }
+    }
+}
+
+void ChaosController::collectParameterChanges(const std::array<float, ultraglitch::params::NUM_PARAMETERS>& currentValues,
+                                              GeneratedParameterChanges& changes)
+{
+    changes.revertMask |= revertMask_;
+    revertMask_ = 0;
+
+    if (pendingOrderRequest_ != GeneratedParameterChanges::OrderRequest::None)
+    {
+        changes.orderRequest = pendingOrderRequest_;
+        changes.orderSeed = pendingOrderSeed_;
+        pendingOrderRequest_ = GeneratedParameterChanges::OrderRequest::None;
+    }
+
+    if (!isEnabled())
+        return;
+
+    // A host/GUI change to a gliding parameter wins: stop gliding it
+    for (auto bits = glidingMask_ | glideStepMask_; bits != 0; bits &= bits - 1)
+    {
+        const auto index = ultraglitch::params::lowest_set_index(bits);
+        if (currentValues[static_cast<size_t>(index)] != glideApplied_[static_cast<size_t>(index)])
+        {
+            glidingMask_ &= ~ultraglitch::params::to_mask(index);
+            glideStepMask_ &= ~ultraglitch::params::to_mask(index);
+        }
+    }
+
+    // Emit the latest glide step (the host only ever sees targets, below)
+    for (auto bits = glideStepMask_; bits != 0; bits &= bits - 1)
+    {
+        const auto i = static_cast<size_t>(ultraglitch::params::lowest_set_index(bits));
+        glideApplied_[i] = glideValues_[i];
+        changes.apply(static_cast<ultraglitch::params::ParamIndex>(i), glideValues_[i]);
+    }
+    glideStepMask_ = 0;
+
+    // New targets from the last trigger: jump, or start gliding from the current value
+    for (auto bits = pendingMask_; bits != 0; bits &= bits - 1)
+    {
+        const auto index = ultraglitch::params::lowest_set_index(bits);
+        const auto i = static_cast<size_t>(index);
+        const auto bit = ultraglitch::params::to_mask(index);
+        const float target = pendingValues_[i];
+
+        // Internal mode skips the host entirely: no gestures, no listeners, no repaints
+        if (hostSync_)
+            changes.publish(index, target);
+        else
+            internalMask_ |= bit;
+
+        if (slewMs_ <= 0.0f)
+        {
+            changes.apply(index, target);
+            glidingMask_ &= ~bit;
             continue;
+        }
+
+        if (glidingMask_ == 0)
+            controlCounter_ = 0; // Start the control grid with the first glide
+
+        if ((glidingMask_ & bit) == 0)
+        {
+            glideValues_[i] = currentValues[i];
+            glideApplied_[i] = currentValues[i];
+        }
+
+        glideTargets_[i] = target;
+        glidingMask_ |= bit;
+    }
+
+    pendingMask_ = 0;
+}
+
+bool ChaosController::isRandomizable(ultraglitch::params::ParamIndex index)
+{
+    using ultraglitch::params::ParamIndex;
+
+    // Don't randomize ChaosController's own parameters or global gain
+    return index != ParamIndex::Global_ChaosMode &&
+           index != ParamIndex::ChaosController_Speed &&
+           index != ParamIndex::ChaosController_Intensity &&
+           index != ParamIndex::ChaosController_Slew &&
+           index != ParamIndex::ChaosController_HostSync &&
+           index != ParamIndex::ChaosController_Reorder &&
+           index != ParamIndex::Global_Gain;
+}
+
+void ChaosController::randomizeParameters()
+{
+    using ultraglitch::params::ParamIndex;
+
+    for (int i = 0; i < ultraglitch::params::NUM_PARAMETERS; ++i)
+    {
+        const auto index = static_cast<ParamIndex>(i);
+
+        if (!isRandomizable(index))
+            continue;
+
+        const auto& spec = ultraglitch::params::get_parameter_spec(index);
 
         // Randomly decide if this parameter should be changed based on intensity
-        if (juceRandomGenerator_.nextFloat() < intensity_) // Intensity is 0-1, acts as probability
+        if (randomGenerator_.nextFloat() < intensity_) // Intensity is 0-1, acts as probability
         {
-            float minValue = paramDef.minValue;
-            float maxValue = paramDef.maxValue;
+            float newValue = randomGenerator_.nextFloat() * (spec.maxValue - spec.minValue) + spec.minValue;
+
+            // Snap like the APVTS would, so DSP and host-visible values stay identical
+            if (spec.stepValue > 0.0f)
+                newValue = juce::jlimit(spec.minValue, spec.maxValue,
+                                        spec.minValue + spec.stepValue * std::round((newValue - spec.minValue) / spec.stepValue));
 
-            float newValue = juceRandomGenerator_.nextFloat() * (maxValue - minValue) + minValue;
-            pluginParameters_->set_parameter_value(paramDef.id, newValue);
+            pendingValues_[static_cast<size_t>(i)] = newValue;
+            pendingMask_ |= ultraglitch::params::to_mask(index);
         }
     }
+
+    // Drawn last, so the parameter sequence is the same with or without reordering
+    if (reorder_)
+    {
+        pendingOrderRequest_ = GeneratedParameterChanges::OrderRequest::Shuffle;
+        pendingOrderSeed_ = randomGenerator_.nextInt();
+        orderShuffled_ = true;
+    }
 }
 
 } // namespace ultraglitch::dsp
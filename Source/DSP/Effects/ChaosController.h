@@ -3,44 +3,69 @@
 #include "../EffectBase.h" // Points to ultraglitch::dsp::EffectBase
 #include "../../Common/DSPUtils.h" // Points to ultraglitch::dsp::DSPUtils
 #include "../../Common/ParameterIDs.h" // For parameter IDs
-#include "../../Parameters/PluginParameters.h" // To access other plugin parameters
-#include <random>
+#include "../../Parameters/ParameterRegistry.h" // Ranges of the parameters it randomizes
+#include <array>
 
 namespace ultraglitch::dsp
 {
-class ChaosController : public ultraglitch::dsp::EffectBase
+class ChaosController final : public ultraglitch::dsp::EffectBase
 {
 public:
-    // ChaosController needs access to all plugin parameters to randomize them.
-    explicit ChaosController(PluginParameters* pluginParameters);
+    // Binds its own parameters; randomized values are produced on the audio thread
+    // and reach the other effects through EffectChain (see collectParameterChanges()).
+    explicit ChaosController(const PluginParameters* pluginParameters = nullptr);
     ~ChaosController() override = default;
 
     void prepare(double sampleRate, int maxBlockSize) override;
     void process(juce::AudioBuffer<float>& buffer) override; // Does not process audio, but triggers updates
+    void process(juce::AudioBuffer<double>& buffer) override; // Same, only the length matters
     void reset() override;
+    [[nodiscard]] int getSamplesUntilNextChangePoint() const override;
+    [[nodiscard]] int getTailSamples() const override { return 0; } // Never touches the audio
+    [[nodiscard]] bool canSleep() const override { return false; } // Triggers keep their timing on silence
+    [[nodiscard]] bool writesAudio() const override { return false; }
 
     // Parameter setter from PluginParameters/EffectChain
-    void setParameterValue(const juce::String& paramID, float value) override;
+    void setParameterValue(ultraglitch::params::ParamIndex index, float value) override;
+    void collectParameterChanges(const std::array<float, ultraglitch::params::NUM_PARAMETERS>& currentValues,
+                                 GeneratedParameterChanges& changes) override;
 
     // Specific parameter setters (internal, might be called by setParameterValue)
     void setSpeed(float speed); // chaosSpeed (changes per second)
     void setIntensity(float intensity); // chaosIntensity (range of randomization)
+    void setSlew(float slewMs); // chaosSlew: time to glide (99%) to a new target, 0 = jump
+    void setHostSync(bool shouldSync); // chaosHostSync: publish targets to the host, or keep them internal
+    void setReorder(bool shouldReorder); // chaosReorder: shuffle the chain order on each trigger
 
-    // Public method to trigger randomization (called from message thread)
-    void randomizeParameters();
-
-    // Methods to manage randomization trigger from audio thread
-    bool shouldTriggerRandomization() { return shouldTriggerRandomization_.exchange(false); } // Get and clear
-    void clearRandomizationTrigger() { shouldTriggerRandomization_.store(false); } // Explicitly clear
+    // Restarts the trigger phase and the random sequence (audio thread, e.g. on transport start)
+    void restartSequence();
 
     [[nodiscard]] juce::String getName() const override { return "ChaosController"; }
 
+    // Fixed seed: reset() restarts the sequence, so an offline bounce reproduces playback
+    static constexpr juce::int64 RANDOM_SEED = 0x6c697463686f73;
+
+    // Morph glides advance on a fixed grid of this many samples (a change point each)
+    static constexpr int MORPH_CONTROL_INTERVAL_SAMPLES = 64;
+
 private:
-    PluginParameters* pluginParameters_ = nullptr; // Raw pointer, owned by PluginProcessor
+    void advance(int numSamples); // Both process() overloads: moves triggers and glides on
+
+    // Draws new values for the randomizable parameters into pendingValues_ (audio thread)
+    void randomizeParameters();
+    static bool isRandomizable(ultraglitch::params::ParamIndex index);
+    void requestOrderRestore();
+
+    // One control-rate step of every glide at once (vectorized one-pole)
+    void advanceGlides();
+    void updateGlideCoefficient();
 
     // Parameters
     float speed_ = 1.0f; // Rate of randomization in Hz (tasq.md: 1/8 note)
     float intensity_ = 0.5f; // Amount of randomization (0.0 to 1.0)
+    float slewMs_ = 0.0f; // Morph glide time, 0 = jump straight to the new values
+    bool hostSync_ = true; // Off: values are applied but never published (internal modulation)
+    bool reorder_ = false;
 
     double currentSampleRate_ = 0.0;
     int currentMaxBlockSize_ = 0;
@@ -49,10 +74,31 @@ private:
     int samplesCounter_ = 0;
     int updateIntervalSamples_ = 0; // Number of samples between randomization triggers
 
-    std::mt19937 randomGenerator_; // Standard Mersenne Twister engine
-    juce::Random juceRandomGenerator_; // For convenient JUCE random functions
+    juce::Random randomGenerator_; // Deterministic, reseeded in reset()
+
+    // Randomized values not yet collected by EffectChain (audio thread only)
+    std::array<float, ultraglitch::params::NUM_PARAMETERS> pendingValues_{};
+    ultraglitch::params::ParamMask pendingMask_ = 0;
+
+    // Applied without publishing (host sync off); handed back to the host values via
+    // revertMask_ when chaos stops or host sync comes back on
+    ultraglitch::params::ParamMask internalMask_ = 0;
+    ultraglitch::params::ParamMask revertMask_ = 0;
+
+    // Chain order request for EffectChain (shuffle seed drawn at the trigger)
+    GeneratedParameterChanges::OrderRequest pendingOrderRequest_ = GeneratedParameterChanges::OrderRequest::None;
+    int pendingOrderSeed_ = 0;
+    bool orderShuffled_ = false; // A shuffle was requested since the last restore
 
-    std::atomic<bool> shouldTriggerRandomization_ = false; // Flag to signal randomization from audio thread
+    // Morph state, one lane per ParamIndex (SoA so a glide step is a few vector ops)
+    std::array<float, ultraglitch::params::NUM_PARAMETERS> glideValues_{};
+    std::array<float, ultraglitch::params::NUM_PARAMETERS> glideTargets_{};
+    std::array<float, ultraglitch::params::NUM_PARAMETERS> glideScratch_{};
+    std::array<float, ultraglitch::params::NUM_PARAMETERS> glideApplied_{}; // Last value handed to EffectChain
+    ultraglitch::params::ParamMask glidingMask_ = 0;   // Still moving
+    ultraglitch::params::ParamMask glideStepMask_ = 0; // Advanced since the last collect
+    float glideCoefficient_ = 1.0f; // One-pole coefficient per control step
+    int controlCounter_ = 0;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChaosController)
 };
@@ -1,16 +1,23 @@
 #include "PitchDrift.h"
 #include "../../Common/DSPUtils.h"
 #include "../../Common/ParameterIDs.h"
+#include "../../Common/PluginConfig.h"
+#include <algorithm>
 
 namespace ultraglitch::dsp
 {
 
-PitchDrift::PitchDrift()
-    : delayLine_(MAX_DELAY_SAMPLES)
+PitchDrift::PitchDrift(const PluginParameters* pluginParameters)
 {
     // Initialize base class members
     setEnabled(false); // Start disabled
     setMix(1.0f);      // Default to 100% wet
+
+    using ultraglitch::params::ParamIndex;
+    bindParameter(pluginParameters, ParamIndex::PitchDrift_Enabled);
+    bindParameter(pluginParameters, ParamIndex::PitchDrift_Amount);
+    bindParameter(pluginParameters, ParamIndex::PitchDrift_Speed);
+    bindParameter(pluginParameters, ParamIndex::PitchDrift_Mix);
 }
 
 void PitchDrift::prepare(double sampleRate, int maxBlockSize)
@@ -18,106 +25,128 @@ void PitchDrift::prepare(double sampleRate, int maxBlockSize)
     currentSampleRate_ = sampleRate;
     currentMaxBlockSize_ = maxBlockSize;
     
-    // Prepare delay line with current sample rate and max block size
-    juce::dsp::ProcessSpec spec = { sampleRate, static_cast<juce::uint32>(maxBlockSize), 2 }; // Assuming stereo
-    delayLine_.prepare(spec);
+    // One delay line frame per sample across all channels, in the precision process() gets
+    if (isPreparedFor<double>())
+    {
+        delayLines_.get<double>().prepare(getNumChannels(), MAX_DELAY_SAMPLES);
+        delayLines_.get<float>().release();
+    }
+    else
+    {
+        delayLines_.get<float>().prepare(getNumChannels(), MAX_DELAY_SAMPLES);
+        delayLines_.get<double>().release();
+    }
     
-    dryBuffer_.setSize(2, maxBlockSize); // Preallocate for stereo
+    amountSmoother_.prepare(sampleRate, maxBlockSize);
     
     updateLFO(); // Calculate LFO increment based on current speed and sample rate
     reset();
 }
 
-void PitchDrift::process(juce::AudioBuffer<float>& buffer)
+template <typename SampleType>
+void PitchDrift::processSamples(juce::AudioBuffer<SampleType>& buffer)
 {
     // The EffectChain handles isEnabled() check, so we process if we get here.
+    auto& delayLine = delayLines_.get<SampleType>();
     const int numSamples = buffer.getNumSamples();
-    const int numChannels = buffer.getNumChannels();
+    const int numChannels = juce::jmin(buffer.getNumChannels(), delayLine.getNumChannels()); // As prepared by EffectChain
+
+    // Work on interleaved frames, so every step below runs across all channels at once
+    ScratchArena::Scope scratch(getScratchArena());
+    SampleType* frames = scratch.allocateInterleaved<SampleType>(numChannels, numSamples);
+    if (frames == nullptr)
+        return; // No scratch (not in a prepared EffectChain) or not prepared for this precision: pass through
+
+    ultraglitch::dsp::interleave_channels(buffer.getArrayOfReadPointers(), numChannels, 0, numSamples, frames);
+
+    // Smoothed amount (nullptr once settled)
+    const float* amountRamp = amountSmoother_.getNextBlock(numSamples);
 
-    // Guard: host may deliver blocks larger than maxBlockSize from prepare()
-    if (numSamples > dryBuffer_.getNumSamples() || numChannels > dryBuffer_.getNumChannels())
-        dryBuffer_.setSize(juce::jmax(numChannels, 2), numSamples, false, false, true);
+    // Control rate: the LFO (sin + pow) is evaluated once per block, at its end, and the
+    // delay ramps linearly from the previous block's value. EffectChain keeps blocks at
+    // config::INTERNAL_BLOCK_SIZE, over which a <= 10 Hz sine is close to a straight line.
+    double endPhase = lfoPhase_ + lfoPhaseIncrement_ * numSamples;
+    endPhase -= std::floor(endPhase);
+    const float endAmount = amountRamp != nullptr ? amountRamp[numSamples - 1] : amountCents_;
+    const float endDelaySamples = getDelaySamples(endPhase, endAmount);
+    const float delayStep = (endDelaySamples - lastDelaySamples_) / static_cast<float>(numSamples);
 
-    // Copy input to dryBuffer_ for mixing later
-    for(int ch = 0; ch < numChannels; ++ch)
-        dryBuffer_.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+    std::array<SampleType, ultraglitch::config::MAX_NUM_CHANNELS> wetFrame {};
 
     for (int sampleIdx = 0; sampleIdx < numSamples; ++sampleIdx)
     {
-        // Calculate current LFO value (0.0 to 1.0, then scale by amount)
-        float lfoValue = (std::sin(static_cast<float>(lfoPhase_) * juce::MathConstants<float>::twoPi) * 0.5f + 0.5f); // Sine LFO 0-1
-
-        // Convert cents to a pitch ratio (2^(cents/1200))
-        // amountCents_ is +/- deviation. lfoValue is 0-1.
-        // So total cents variation is +/- amountCents_
-        float pitchDeviationCents = (lfoValue * 2.0f - 1.0f) * amountCents_;
-        float pitchRatio = std::pow(2.0f, pitchDeviationCents / 1200.0f);
-
-        // Modulate delay time to achieve pitch shift
-        // Base delay for static pitch (e.g., 20ms)
-        const float baseDelayMs = 20.0f;
-        const float baseDelaySamples = (baseDelayMs / 1000.0f) * static_cast<float>(currentSampleRate_);
-
-        // Modulated delay time to achieve pitch shift: delay time = base_delay / pitch_ratio
-        // When pitchRatio > 1 (higher pitch), delay time decreases.
-        // When pitchRatio < 1 (lower pitch), delay time increases.
-        float modulatedDelaySamples = baseDelaySamples / pitchRatio;
-
-        // Clamp delay to within reasonable bounds to prevent issues
-        modulatedDelaySamples = ultraglitch::dsp::clamp(modulatedDelaySamples, 1.0f, static_cast<float>(MAX_DELAY_SAMPLES - 1));
-        
-        delayLine_.setDelay(modulatedDelaySamples);
-
-        for (int channel = 0; channel < numChannels; ++channel)
-        {
-            float inputSample = dryBuffer_.getSample(channel, sampleIdx); // Read from dry buffer
-            
-            // Push sample into delay line, get interpolated sample out
-            delayLine_.pushSample(channel, inputSample);
-            float processedSample = delayLine_.popSample(channel);
-            
-            // Apply dry/wet mix from EffectBase
-            buffer.setSample(channel, sampleIdx, ultraglitch::dsp::mix(inputSample, processedSample, getMix()));
-        }
-
-        // Advance LFO phase
-        lfoPhase_ += lfoPhaseIncrement_;
-        if (lfoPhase_ >= 1.0)
-        {
-            lfoPhase_ -= 1.0;
-        }
+        SampleType* frame = frames + sampleIdx * numChannels; // Dry in, wet out (EffectChain mixes)
+
+        // Push the input frame, read the interpolated delayed frame
+        std::copy(frame, frame + numChannels, delayLine.getWriteFrame());
+        delayLine.read(lastDelaySamples_ + delayStep * static_cast<float>(sampleIdx + 1), wetFrame.data());
+        delayLine.advance();
+
+        std::copy(wetFrame.begin(), wetFrame.begin() + numChannels, frame);
     }
+
+    ultraglitch::dsp::deinterleave_channels(frames, numChannels, numSamples, buffer.getArrayOfWritePointers(), 0);
+
+    lfoPhase_ = endPhase;
+    lastDelaySamples_ = endDelaySamples;
+}
+
+void PitchDrift::process(juce::AudioBuffer<float>& buffer)
+{
+    processSamples(buffer);
+}
+
+void PitchDrift::process(juce::AudioBuffer<double>& buffer)
+{
+    processSamples(buffer);
+}
+
+float PitchDrift::getDelaySamples(double phase, float amountCents) const
+{
+    // Sine LFO 0-1; total cents variation is +/- amountCents
+    const float lfoValue = std::sin(static_cast<float>(phase) * juce::MathConstants<float>::twoPi) * 0.5f + 0.5f;
+    const float pitchDeviationCents = (lfoValue * 2.0f - 1.0f) * amountCents;
+    const float pitchRatio = std::pow(2.0f, pitchDeviationCents / 1200.0f); // 2^(cents/1200)
+
+    // Modulate delay time around a 20 ms base: delay time = base_delay / pitch_ratio, so a
+    // higher pitch shortens the delay and a lower one lengthens it
+    const float baseDelaySamples = 0.02f * static_cast<float>(currentSampleRate_);
+    return ultraglitch::dsp::clamp(baseDelaySamples / pitchRatio, 1.0f, static_cast<float>(MAX_DELAY_SAMPLES - 1));
 }
 
 void PitchDrift::reset()
 {
-    delayLine_.reset();
+    delayLines_.get<float>().reset();
+    delayLines_.get<double>().reset();
     lfoPhase_ = 0.0;
+    lastDelaySamples_ = getDelaySamples(lfoPhase_, amountCents_);
 }
 
-void PitchDrift::setParameterValue(const juce::String& paramID, float value)
+int PitchDrift::getTailSamples() const
 {
-    if (paramID == ultraglitch::params::PitchDrift_Enabled)
-    {
-        setEnabled(value > 0.5f);
-    }
-    else if (paramID == ultraglitch::params::PitchDrift_Amount)
-    {
-        setAmount(value);
-    }
-    else if (paramID == ultraglitch::params::PitchDrift_Speed)
-    {
-        setSpeed(value);
-    }
-    else if (paramID == ultraglitch::params::PitchDrift_Mix)
+    // Longest delay the LFO reaches at the current amount (pitched fully down)
+    const double longestDelay = 0.02 * currentSampleRate_ * std::pow(2.0, amountCents_ / 1200.0);
+    return juce::jmin(MAX_DELAY_SAMPLES, static_cast<int>(std::ceil(longestDelay)) + 1);
+}
+
+void PitchDrift::setParameterValue(ultraglitch::params::ParamIndex index, float value)
+{
+    using ultraglitch::params::ParamIndex;
+
+    switch (index)
     {
-        setMix(value); // Param is 0..1, pass directly
+        case ParamIndex::PitchDrift_Enabled: setEnabled(value > 0.5f); break;
+        case ParamIndex::PitchDrift_Amount:  setAmount(value); break;
+        case ParamIndex::PitchDrift_Speed:   setSpeed(value); break;
+        case ParamIndex::PitchDrift_Mix:     setMix(value); break; // Param is 0..1, pass directly
+        default: break;
     }
 }
 
 void PitchDrift::setAmount(float amountCents)
 {
     amountCents_ = ultraglitch::dsp::clamp(amountCents, 0.0f, 1200.0f); // Match param definition 0..1200 cents
+    amountSmoother_.setTargetValue(amountCents_);
 }
 
 void PitchDrift::setSpeed(float speedHz)
@@ -3,22 +3,26 @@
 #include "../EffectBase.h" // Points to ultraglitch::dsp::EffectBase
 #include "../../Common/DSPUtils.h" // Points to ultraglitch::dsp::DSPUtils
 #include "../../Common/ParameterIDs.h" // For parameter IDs
-#include <juce_dsp/juce_dsp.h> // For juce::dsp::DelayLine
+#include "../FrameDelayLine.h"
+#include <array>
 
 namespace ultraglitch::dsp
 {
-class PitchDrift : public ultraglitch::dsp::EffectBase
+class PitchDrift final : public ultraglitch::dsp::EffectBase
 {
 public:
-    PitchDrift();
+    // pluginParameters may be nullptr (effect then keeps its defaults until set explicitly)
+    explicit PitchDrift(const PluginParameters* pluginParameters = nullptr);
     ~PitchDrift() override = default;
 
     void prepare(double sampleRate, int maxBlockSize) override;
     void process(juce::AudioBuffer<float>& buffer) override;
+    void process(juce::AudioBuffer<double>& buffer) override;
     void reset() override;
+    [[nodiscard]] int getTailSamples() const override;
 
     // Parameter setter from PluginParameters/EffectChain
-    void setParameterValue(const juce::String& paramID, float value) override;
+    void setParameterValue(ultraglitch::params::ParamIndex index, float value) override;
 
     // Specific parameter setters (internal, might be called by setParameterValue)
     void setAmount(float amountCents); // pdAmount (cents)
@@ -27,7 +31,11 @@ public:
     [[nodiscard]] juce::String getName() const override { return "PitchDrift"; }
 
 private:
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer);
+
     void updateLFO(); // Method to update LFO frequency and phase
+    float getDelaySamples(double phase, float amountCents) const; // Delay line setting at an LFO phase
 
     double currentSampleRate_ = 0.0;
     int currentMaxBlockSize_ = 0;
@@ -35,17 +43,18 @@ private:
     // Parameters
     float amountCents_ = 0.0f; // Total pitch deviation in cents (e.g., +/- 100 cents)
     float speedHz_ = 1.0f; // LFO speed in Hz
+    ParameterSmoother amountSmoother_; // Ramps amountCents_ to avoid pitch jumps
 
     // LFO state
     double lfoPhase_ = 0.0;
     double lfoPhaseIncrement_ = 0.0; // In radians per sample
+    float lastDelaySamples_ = 1.0f; // Delay at the end of the previous block (ramp start)
 
     // Delay line for pitch shifting
-    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Linear> delayLine_;
+    PrecisionStates<FrameDelayLine> delayLines_; // Linear interpolation, all channels per frame
     static constexpr int MAX_DELAY_SAMPLES = 88200; // Max 2 seconds delay at 44.1kHz * 2 for +/- pitch shift
 
     juce::Random randomGenerator_; // For potential random LFO or other variations
-    juce::AudioBuffer<float> dryBuffer_; // Preallocated buffer for dry signal
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PitchDrift)
 };
@@ -5,12 +5,16 @@
 namespace ultraglitch::dsp
 {
 
-ReverseSlice::ReverseSlice()
+ReverseSlice::ReverseSlice(const PluginParameters* pluginParameters)
 {
     setEnabled(false);
     setMix(0.0f);
 
-    internalBuffer_.setSize(2, MAX_SLICE_BUFFER_SAMPLES, false, true, true);
+    using ultraglitch::params::ParamIndex;
+    bindParameter(pluginParameters, ParamIndex::ReverseSlice_Enabled);
+    bindParameter(pluginParameters, ParamIndex::ReverseSlice_Interval);
+    bindParameter(pluginParameters, ParamIndex::ReverseSlice_Chance);
+    bindParameter(pluginParameters, ParamIndex::ReverseSlice_Mix);
 }
 
 void ReverseSlice::prepare(double sampleRate, int maxBlockSize)
@@ -18,136 +22,167 @@ void ReverseSlice::prepare(double sampleRate, int maxBlockSize)
     currentSampleRate_ = sampleRate;
     currentMaxBlockSize_ = maxBlockSize;
 
-    dryBuffer_.setSize(2, maxBlockSize);
+    // Full size for the precision process() gets, empty for the other
+    const int floatSamples = isPreparedFor<float>() ? MAX_SLICE_BUFFER_SAMPLES : 0;
+    const int doubleSamples = isPreparedFor<double>() ? MAX_SLICE_BUFFER_SAMPLES : 0;
 
-    internalBuffer_.clear();
+    for (auto* b : { &sliceBuffers_.get<float>().internalBuffer, &sliceBuffers_.get<float>().processedSliceBuffer,
+                     &sliceBuffers_.get<float>().pendingSliceBuffer })
+        b->setSize(floatSamples > 0 ? getNumChannels() : 0, floatSamples, false, true, false);
 
-    processedSliceBuffer_.setSize(2, MAX_SLICE_BUFFER_SAMPLES, false, true, true);
-    pendingSliceBuffer_.setSize(2, MAX_SLICE_BUFFER_SAMPLES, false, true, true);
+    for (auto* b : { &sliceBuffers_.get<double>().internalBuffer, &sliceBuffers_.get<double>().processedSliceBuffer,
+                     &sliceBuffers_.get<double>().pendingSliceBuffer })
+        b->setSize(doubleSamples > 0 ? getNumChannels() : 0, doubleSamples, false, true, false);
 
     updateInternalState();
     reset();
 }
 
-void ReverseSlice::process(juce::AudioBuffer<float>& buffer)
+template <typename SampleType>
+void ReverseSlice::processSamples(juce::AudioBuffer<SampleType>& buffer)
 {
+    auto& internalBuffer = sliceBuffers_.get<SampleType>().internalBuffer;
     const int numSamples = buffer.getNumSamples();
-    const int numChannels = juce::jmin(buffer.getNumChannels(), 2);
-
-    // Guard: host may deliver blocks larger than maxBlockSize from prepare()
-    if (numSamples > dryBuffer_.getNumSamples() || numChannels > dryBuffer_.getNumChannels())
-        dryBuffer_.setSize(juce::jmax(numChannels, 2), numSamples, false, false, true);
-
-    for (int ch = 0; ch < numChannels; ++ch)
-        dryBuffer_.copyFrom(ch, 0, buffer, ch, 0, numSamples);
-
-    const float currentMix = getMix();
-
-    for (int i = 0; i < numSamples; ++i)
+    const int numChannels = juce::jmin(buffer.getNumChannels(), internalBuffer.getNumChannels()); // As prepared by EffectChain
+    if (numChannels == 0)
+        return; // Not prepared for this precision: pass through
+
+    // The block is handled in runs between slice events (a slice completing, the playing
+    // slice ending); within a run every channel is a plain contiguous copy. Output is wet
+    // only; EffectChain mixes in the dry signal.
+    int sampleIdx = 0;
+    while (sampleIdx < numSamples)
     {
-        // Build slice
-        if (samplesSinceLastSlice_ < sliceIntervalSamples_)
+        const int samplesUntilComplete = juce::jmax(1, sliceIntervalSamples_ - samplesSinceLastSlice_);
+        const int samplesUntilPlaybackEnd = isPlayingSlice_ ? juce::jmax(1, sliceIntervalSamples_ - playheadInSlice_)
+                                                            : numSamples;
+        const int runSamples = juce::jmin(numSamples - sampleIdx, samplesUntilComplete, samplesUntilPlaybackEnd);
+
+        // Build slice (the run's input is only overwritten below)
+        const int captureSamples = juce::jlimit(0, runSamples, sliceIntervalSamples_ - samplesSinceLastSlice_);
+        if (captureSamples > 0)
         {
             for (int ch = 0; ch < numChannels; ++ch)
-                internalBuffer_.setSample(ch, samplesSinceLastSlice_,
-                                          dryBuffer_.getSample(ch, i));
+                internalBuffer.copyFrom(ch, samplesSinceLastSlice_, buffer, ch, sampleIdx, captureSamples);
 
-            ++samplesSinceLastSlice_;
+            samplesSinceLastSlice_ += captureSamples;
         }
 
-        // Slice completed
         if (samplesSinceLastSlice_ >= sliceIntervalSamples_)
         {
-            juce::AudioBuffer<float>* target = nullptr;
+            // Completes on the run's last sample, whose output already sees the new slice
+            writeOutput(buffer, sampleIdx, runSamples - 1, numChannels);
+            completeSlice<SampleType>(numChannels);
+            writeOutput(buffer, sampleIdx + runSamples - 1, 1, numChannels);
+        }
+        else
+        {
+            writeOutput(buffer, sampleIdx, runSamples, numChannels);
+        }
 
-            if (!isPlayingSlice_)
-            {
-                target = &processedSliceBuffer_;
-            }
-            else
-            {
-                target = &pendingSliceBuffer_;
-                pendingSliceReady_ = true;
-            }
+        sampleIdx += runSamples;
+    }
+}
 
-            for (int ch = 0; ch < numChannels; ++ch)
-                target->copyFrom(ch, 0, internalBuffer_, ch, 0, sliceIntervalSamples_);
+void ReverseSlice::process(juce::AudioBuffer<float>& buffer)
+{
+    processSamples(buffer);
+}
 
-            if (randomGenerator_.nextFloat() < reverseChance_)
-            {
-                reverseAudioSegment(*target, 0, sliceIntervalSamples_);
-                ultraglitch::dsp::apply_slice_crossfade(*target, 0, sliceIntervalSamples_);
-            }
+void ReverseSlice::process(juce::AudioBuffer<double>& buffer)
+{
+    processSamples(buffer);
+}
 
-            samplesSinceLastSlice_ = 0;
-            internalBuffer_.clear();
+template <typename SampleType>
+void ReverseSlice::completeSlice(int numChannels)
+{
+    auto& buffers = sliceBuffers_.get<SampleType>();
+    juce::AudioBuffer<SampleType>* target = nullptr;
 
-            if (!isPlayingSlice_)
-            {
-                isPlayingSlice_ = true;
-                playheadInSlice_ = 0;
-            }
-        }
+    if (!isPlayingSlice_)
+    {
+        target = &buffers.processedSliceBuffer;
+    }
+    else
+    {
+        target = &buffers.pendingSliceBuffer;
+        pendingSliceReady_ = true;
+    }
 
-        // Output
-        for (int ch = 0; ch < numChannels; ++ch)
-        {
-            float dry = dryBuffer_.getSample(ch, i);
-            float wet = dry;
+    for (int ch = 0; ch < numChannels; ++ch)
+        target->copyFrom(ch, 0, buffers.internalBuffer, ch, 0, sliceIntervalSamples_);
 
-            if (isPlayingSlice_)
-            {
-                int safeIdx = juce::jlimit(0, sliceIntervalSamples_ - 1, playheadInSlice_);
-                wet = processedSliceBuffer_.getSample(ch, safeIdx);
-            }
+    if (randomGenerator_.nextFloat() < reverseChance_)
+    {
+        reverseAudioSegment(*target, 0, sliceIntervalSamples_);
+        ultraglitch::dsp::apply_slice_crossfade(*target, 0, sliceIntervalSamples_);
+    }
 
-            float out =
-                (currentMix <= 0.0f) ? dry :
-                (currentMix >= 1.0f) ? wet :
-                ultraglitch::dsp::mix(dry, wet, currentMix);
+    // No need to clear internalBuffer_: the next slice overwrites all of it that is read
+    samplesSinceLastSlice_ = 0;
 
-            buffer.setSample(ch, i, out);
-        }
+    if (!isPlayingSlice_)
+    {
+        isPlayingSlice_ = true;
+        playheadInSlice_ = 0;
+    }
+}
+
+template <typename SampleType>
+void ReverseSlice::writeOutput(juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples, int numChannels)
+{
+    if (numSamples <= 0 || !isPlayingSlice_)
+        return; // Nothing playing: the wet signal is the dry one, buffer stays as it is
+
+    // numSamples never runs past the slice; a playhead beyond a shortened interval holds
+    // the last sample for its one remaining output sample
+    const int readStart = juce::jmin(playheadInSlice_, sliceIntervalSamples_ - 1);
+    auto& processedSliceBuffer = sliceBuffers_.get<SampleType>().processedSliceBuffer;
+    auto& pendingSliceBuffer = sliceBuffers_.get<SampleType>().pendingSliceBuffer;
 
-        // Advance playback
-        if (isPlayingSlice_)
+    for (int ch = 0; ch < numChannels; ++ch)
+        buffer.copyFrom(ch, startSample, processedSliceBuffer, ch, readStart, numSamples);
+
+    // Advance playback
+    playheadInSlice_ += numSamples;
+
+    if (playheadInSlice_ >= sliceIntervalSamples_)
+    {
+        isPlayingSlice_ = false;
+        playheadInSlice_ = 0;
+
+        if (pendingSliceReady_)
         {
-            ++playheadInSlice_;
+            // RT-safe content swap (no allocations)
+            const int channels = processedSliceBuffer.getNumChannels();
+            const int samples  = processedSliceBuffer.getNumSamples();
 
-            if (playheadInSlice_ >= sliceIntervalSamples_)
+            for (int ch = 0; ch < channels; ++ch)
             {
-                isPlayingSlice_ = false;
-                playheadInSlice_ = 0;
-
-                if (pendingSliceReady_)
-                {
-                    // RT-safe content swap (no allocations)
-                    const int channels = processedSliceBuffer_.getNumChannels();
-                    const int samples  = processedSliceBuffer_.getNumSamples();
-
-                    for (int ch = 0; ch < channels; ++ch)
-                    {
-                        float* a = processedSliceBuffer_.getWritePointer(ch);
-                        float* b = pendingSliceBuffer_.getWritePointer(ch);
-
-                        for (int s = 0; s < samples; ++s)
-                            std::swap(a[s], b[s]);
-                    }
-
-                    pendingSliceReady_ = false;
-                    isPlayingSlice_ = true;
-                    playheadInSlice_ = 0;
-                }
+                SampleType* a = processedSliceBuffer.getWritePointer(ch);
+                SampleType* b = pendingSliceBuffer.getWritePointer(ch);
+
+                for (int s = 0; s < samples; ++s)
+                    std::swap(a[s], b[s]);
             }
+
+            pendingSliceReady_ = false;
+            isPlayingSlice_ = true;
+            playheadInSlice_ = 0;
         }
     }
 }
 
 void ReverseSlice::reset()
 {
-    internalBuffer_.clear();
-    processedSliceBuffer_.clear();
-    pendingSliceBuffer_.clear();
+    for (auto* b : { &sliceBuffers_.get<float>().internalBuffer, &sliceBuffers_.get<float>().processedSliceBuffer,
+                     &sliceBuffers_.get<float>().pendingSliceBuffer })
+        b->clear();
+
+    for (auto* b : { &sliceBuffers_.get<double>().internalBuffer, &sliceBuffers_.get<double>().processedSliceBuffer,
+                     &sliceBuffers_.get<double>().pendingSliceBuffer })
+        b->clear();
 
     samplesSinceLastSlice_ = 0;
     isPlayingSlice_ = false;
@@ -157,16 +192,25 @@ void ReverseSlice::reset()
     randomGenerator_.setSeed(juce::Time::currentTimeMillis());
 }
 
-void ReverseSlice::setParameterValue(const juce::String& paramID, float value)
+int ReverseSlice::getTailSamples() const
+{
+    // The slice being captured when the input stops may have to wait for the one playing
+    // to finish, then plays for a full interval itself
+    return 2 * sliceIntervalSamples_;
+}
+
+void ReverseSlice::setParameterValue(ultraglitch::params::ParamIndex index, float value)
 {
-    if (paramID == ultraglitch::params::ReverseSlice_Enabled)
-        setEnabled(value > 0.5f);
-    else if (paramID == ultraglitch::params::ReverseSlice_Interval)
-        setSliceIntervalMs(value);
-    else if (paramID == ultraglitch::params::ReverseSlice_Chance)
-        setReverseChance(value);
-    else if (paramID == ultraglitch::params::ReverseSlice_Mix)
-        setMix(value);
+    using ultraglitch::params::ParamIndex;
+
+    switch (index)
+    {
+        case ParamIndex::ReverseSlice_Enabled:  setEnabled(value > 0.5f); break;
+        case ParamIndex::ReverseSlice_Interval: setSliceIntervalMs(value); break;
+        case ParamIndex::ReverseSlice_Chance:   setReverseChance(value); break;
+        case ParamIndex::ReverseSlice_Mix:      setMix(value); break;
+        default: break;
+    }
 }
 
 void ReverseSlice::setSliceIntervalMs(float intervalMs)
@@ -190,7 +234,8 @@ void ReverseSlice::updateInternalState()
         juce::jmin(sliceIntervalSamples_, MAX_SLICE_BUFFER_SAMPLES);
 }
 
-void ReverseSlice::reverseAudioSegment(juce::AudioBuffer<float>& buffer,
+template <typename SampleType>
+void ReverseSlice::reverseAudioSegment(juce::AudioBuffer<SampleType>& buffer,
                                        int startSample,
                                        int numSamples)
 {
@@ -198,7 +243,7 @@ void ReverseSlice::reverseAudioSegment(juce::AudioBuffer<float>& buffer,
 
     for (int ch = 0; ch < numChannels; ++ch)
     {
-        float* data = buffer.getWritePointer(ch);
+        SampleType* data = buffer.getWritePointer(ch);
 
         for (int i = 0; i < numSamples / 2; ++i)
         {
@@ -9,17 +9,20 @@
 namespace ultraglitch::dsp
 {
 
-class ReverseSlice : public ultraglitch::dsp::EffectBase
+class ReverseSlice final : public ultraglitch::dsp::EffectBase
 {
 public:
-    ReverseSlice();
+    // pluginParameters may be nullptr (effect then keeps its defaults until set explicitly)
+    explicit ReverseSlice(const PluginParameters* pluginParameters = nullptr);
     ~ReverseSlice() override = default;
 
     void prepare(double sampleRate, int maxBlockSize) override;
     void process(juce::AudioBuffer<float>& buffer) override;
+    void process(juce::AudioBuffer<double>& buffer) override;
     void reset() override;
+    [[nodiscard]] int getTailSamples() const override;
 
-    void setParameterValue(const juce::String& paramID, float value) override;
+    void setParameterValue(ultraglitch::params::ParamIndex index, float value) override;
 
     void setSliceIntervalMs(float intervalMs);
     void setReverseChance(float chance);
@@ -27,13 +30,31 @@ public:
     [[nodiscard]] juce::String getName() const override { return "ReverseSlice"; }
 
 private:
+    // Slice audio, one set per precision (see PrecisionStates)
+    template <typename SampleType>
+    struct SliceBuffers
+    {
+        juce::AudioBuffer<SampleType> internalBuffer;
+        juce::AudioBuffer<SampleType> processedSliceBuffer;
+        juce::AudioBuffer<SampleType> pendingSliceBuffer;
+    };
+
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer);
+
     void updateInternalState();
-    void reverseAudioSegment(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
 
-    juce::AudioBuffer<float> internalBuffer_;
-    juce::AudioBuffer<float> processedSliceBuffer_;
-    juce::AudioBuffer<float> pendingSliceBuffer_;
-    juce::AudioBuffer<float> dryBuffer_;
+    template <typename SampleType>
+    void reverseAudioSegment(juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples);
+
+    template <typename SampleType>
+    void completeSlice(int numChannels); // Hands the captured slice to playback (or queues it)
+
+    template <typename SampleType>
+    void writeOutput(juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples,
+                     int numChannels); // Writes the playing slice and advances playback
+
+    PrecisionStates<SliceBuffers> sliceBuffers_;
 
     juce::Random randomGenerator_;
 
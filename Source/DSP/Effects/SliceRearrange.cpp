@@ -6,13 +6,19 @@
 namespace ultraglitch::dsp
 {
 
-SliceRearrange::SliceRearrange()
+SliceRearrange::SliceRearrange(const PluginParameters* pluginParameters)
     : randomEngine_(std::random_device{}()), // Initialize std::mt19937
       juceRandomGenerator_(juce::Time::currentTimeMillis()) // Initialize juce::Random
 {
     // Initialize base class members
     setEnabled(false); // Start disabled
     setMix(0.0f);      // Default to 0% wet as per tasq.md
+
+    using ultraglitch::params::ParamIndex;
+    bindParameter(pluginParameters, ParamIndex::SliceRearrange_Enabled);
+    bindParameter(pluginParameters, ParamIndex::SliceRearrange_SliceCount);
+    bindParameter(pluginParameters, ParamIndex::SliceRearrange_Randomize);
+    bindParameter(pluginParameters, ParamIndex::SliceRearrange_Mix);
 }
 
 void SliceRearrange::prepare(double sampleRate, int maxBlockSize)
@@ -20,146 +26,148 @@ void SliceRearrange::prepare(double sampleRate, int maxBlockSize)
     currentSampleRate_ = sampleRate;
     currentMaxBlockSize_ = maxBlockSize;
     
-    // Preallocate internal buffers for real-time safety
-    dryBuffer_.setSize(2, maxBlockSize);
-    dryBuffer_.clear();
-    blockBuffer_.setSize(2, maxBlockSize); // Buffer to hold the entire input block for processing
-    blockBuffer_.clear();
-    processedBuffer_.setSize(2, maxBlockSize); // Buffer to build the rearranged output
-    processedBuffer_.clear();
-
     // Ensure sliceOrder_ has enough capacity
     sliceOrder_.reserve(ultraglitch::params::SliceRearrange_MAX_SLICE_COUNT);
 
+    // One window each; independent of maxBlockSize. Empty for the precision not in use.
+    const int floatChannels = isPreparedFor<float>() ? getNumChannels() : 0;
+    const int doubleChannels = isPreparedFor<double>() ? getNumChannels() : 0;
+    windows_.get<float>().captureBuffer.setSize(floatChannels, floatChannels > 0 ? WINDOW_SAMPLES : 0);
+    windows_.get<float>().playbackBuffer.setSize(floatChannels, floatChannels > 0 ? WINDOW_SAMPLES : 0);
+    windows_.get<double>().captureBuffer.setSize(doubleChannels, doubleChannels > 0 ? WINDOW_SAMPLES : 0);
+    windows_.get<double>().playbackBuffer.setSize(doubleChannels, doubleChannels > 0 ? WINDOW_SAMPLES : 0);
+
     updateInternalState(); // Calculate slice boundaries and initial order
     reset();
 }
 
-void SliceRearrange::process(juce::AudioBuffer<float>& buffer)
+template <typename SampleType>
+void SliceRearrange::processSamples(juce::AudioBuffer<SampleType>& buffer)
 {
-    const int numChannels = buffer.getNumChannels();
+    auto& window = windows_.get<SampleType>();
+    const int numChannels = juce::jmin(buffer.getNumChannels(), window.captureBuffer.getNumChannels());
+    if (numChannels == 0)
+        return; // Not prepared for this precision: pass through
+
     const int numSamples = buffer.getNumSamples();
 
-    // Guard: host may deliver blocks larger than maxBlockSize from prepare()
-    if (numSamples > dryBuffer_.getNumSamples() || numChannels > dryBuffer_.getNumChannels())
+    // Slices come from fixed windows of WINDOW_SAMPLES rather than from whatever block the
+    // chain passes in, so the sound doesn't depend on the host or sub-block size. Each
+    // window is captured while the previous one plays back rearranged. Output is wet only;
+    // EffectChain mixes in the dry signal.
+    int sampleIdx = 0;
+    while (sampleIdx < numSamples)
     {
-        const int ch = juce::jmax(numChannels, 2);
-        dryBuffer_.setSize(ch, numSamples, false, false, true);
-        blockBuffer_.setSize(ch, numSamples, false, false, true);
-        processedBuffer_.setSize(ch, numSamples, false, false, true);
-    }
+        const int chunkSamples = juce::jmin(numSamples - sampleIdx, WINDOW_SAMPLES - samplesAccumulated_);
 
-    // Copy input to dryBuffer_ for mixing later
-    for(int ch = 0; ch < numChannels; ++ch)
-        dryBuffer_.copyFrom(ch, 0, buffer, ch, 0, numSamples);
-    
-    // Copy input buffer to our internal blockBuffer_
-    for (int channel = 0; channel < numChannels; ++channel)
-    {
-        blockBuffer_.copyFrom(channel, 0, buffer, channel, 0, numSamples);
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            // Capture the input before the playback below overwrites it
+            window.captureBuffer.copyFrom(channel, samplesAccumulated_, buffer, channel, sampleIdx, chunkSamples);
+            buffer.copyFrom(channel, sampleIdx, window.playbackBuffer, channel, samplesAccumulated_, chunkSamples);
+        }
+
+        sampleIdx += chunkSamples;
+        samplesAccumulated_ += chunkSamples;
+
+        if (samplesAccumulated_ == WINDOW_SAMPLES)
+        {
+            rearrangeCapturedWindow<SampleType>();
+            samplesAccumulated_ = 0;
+        }
     }
+}
+
+void SliceRearrange::process(juce::AudioBuffer<float>& buffer)
+{
+    processSamples(buffer);
+}
+
+void SliceRearrange::process(juce::AudioBuffer<double>& buffer)
+{
+    processSamples(buffer);
+}
+
+template <typename SampleType>
+void SliceRearrange::rearrangeCapturedWindow()
+{
+    auto& captureBuffer = windows_.get<SampleType>().captureBuffer;
+    auto& playbackBuffer = windows_.get<SampleType>().playbackBuffer;
 
-    // Generate new slice order if randomizeAmount_ is active
-    // This is done once per process block for simplicity in PoC
-    if (randomizeAmount_ > 0.0f) // Only randomize if randomizeAmount is active
+    // Reshuffle the existing order once per window if randomizeAmount_ is active.
+    // The order vector itself is only rebuilt when sliceCount_ changes.
+    if (randomizeAmount_ > 0.0f)
     {
-        updateInternalState(); // This will regenerate slice order
+        std::shuffle(sliceOrder_.begin(), sliceOrder_.end(), randomEngine_);
     }
-    
-    processedBuffer_.clear(); // Clear the buffer where we'll build the rearranged output
 
-    // Calculate slice parameters
-    int samplesPerSlice = numSamples / sliceCount_;
-    int remainder = numSamples % sliceCount_;
+    const int samplesPerSlice = WINDOW_SAMPLES / sliceCount_;
+    const int remainder = WINDOW_SAMPLES % sliceCount_; // Distributed among the first slices
 
-    // Iterate through the randomized slice order and copy slices from blockBuffer_ to processedBuffer_
+    // Copy the captured slices into the playback window in the (shuffled) order
     int currentOutputPos = 0;
     for (int orderedSliceIndex : sliceOrder_)
     {
-        int actualSliceLength = samplesPerSlice;
-        if (orderedSliceIndex < remainder) // Distribute remainder samples among first slices
-            actualSliceLength++;
-        
-        // Calculate start position of the current slice in the original blockBuffer_
-        int currentSliceStartInBlock = 0;
-        for (int i = 0; i < orderedSliceIndex; ++i)
-        {
-            int prevSliceLength = samplesPerSlice;
-            if (i < remainder)
-                prevSliceLength++;
-            currentSliceStartInBlock += prevSliceLength;
-        }
+        const int sliceLength = samplesPerSlice + (orderedSliceIndex < remainder ? 1 : 0);
+        const int sliceStart = orderedSliceIndex * samplesPerSlice + juce::jmin(orderedSliceIndex, remainder);
 
-        // Copy slice from blockBuffer_ to processedBuffer_
-        if (actualSliceLength > 0 && currentSliceStartInBlock + actualSliceLength <= numSamples)
+        for (int channel = 0; channel < playbackBuffer.getNumChannels(); ++channel)
         {
-            for (int channel = 0; channel < numChannels; ++channel)
-            {
-                processedBuffer_.copyFrom(channel, currentOutputPos, blockBuffer_, channel, currentSliceStartInBlock, actualSliceLength);
-            }
-            // Apply crossfade at slice boundaries to smooth transitions
-            ultraglitch::dsp::apply_slice_crossfade(processedBuffer_, currentOutputPos, actualSliceLength);
-            currentOutputPos += actualSliceLength;
+            playbackBuffer.copyFrom(channel, currentOutputPos, captureBuffer, channel, sliceStart, sliceLength);
         }
-    }
-
-    // Apply dry/wet mix from EffectBase
-    float currentMix = getMix();
-    if (currentMix == 0.0f) return; // Completely dry, no need to mix
-
-    for (int channel = 0; channel < numChannels; ++channel)
-    {
-        float* outputChannelData = buffer.getWritePointer(channel);
-        const float* dryChannelData = dryBuffer_.getReadPointer(channel);
-        const float* wetChannelData = processedBuffer_.getReadPointer(channel);
 
-        for (int sampleIdx = 0; sampleIdx < numSamples; ++sampleIdx)
-        {
-            outputChannelData[sampleIdx] = ultraglitch::dsp::mix(dryChannelData[sampleIdx], wetChannelData[sampleIdx], currentMix);
-        }
+        // Apply crossfade at slice boundaries to smooth transitions
+        ultraglitch::dsp::apply_slice_crossfade(playbackBuffer, currentOutputPos, sliceLength);
+        currentOutputPos += sliceLength;
     }
 }
 
 void SliceRearrange::reset()
 {
-    blockBuffer_.clear();
-    processedBuffer_.clear();
     samplesAccumulated_ = 0;
+    windows_.get<float>().captureBuffer.clear();
+    windows_.get<float>().playbackBuffer.clear();
+    windows_.get<double>().captureBuffer.clear();
+    windows_.get<double>().playbackBuffer.clear();
     // Reset random engine if desired, or let it continue its sequence
     // randomEngine_.seed(juce::Time::currentTimeMillis()); // Re-seed if needed
 }
 
-void SliceRearrange::setParameterValue(const juce::String& paramID, float value)
+int SliceRearrange::getTailSamples() const
 {
-    if (paramID == ultraglitch::params::SliceRearrange_Enabled)
-    {
-        setEnabled(value > 0.5f);
-    }
-    else if (paramID == ultraglitch::params::SliceRearrange_SliceCount)
-    {
-        setSliceCount(static_cast<int>(value));
-    }
-    else if (paramID == ultraglitch::params::SliceRearrange_Randomize)
-    {
-        setRandomizeAmount(value); // Value is already 0-1
-    }
-    else if (paramID == ultraglitch::params::SliceRearrange_Mix)
+    // The window being captured plays back (rearranged) during the next one
+    return 2 * WINDOW_SAMPLES;
+}
+
+void SliceRearrange::setParameterValue(ultraglitch::params::ParamIndex index, float value)
+{
+    using ultraglitch::params::ParamIndex;
+
+    switch (index)
     {
-        setMix(value); // Mix parameter is 0-1
+        case ParamIndex::SliceRearrange_Enabled:    setEnabled(value > 0.5f); break;
+        case ParamIndex::SliceRearrange_SliceCount: setSliceCount(static_cast<int>(value)); break;
+        case ParamIndex::SliceRearrange_Randomize:  setRandomizeAmount(value); break; // Value is already 0-1
+        case ParamIndex::SliceRearrange_Mix:        setMix(value); break; // Mix parameter is 0-1
+        default: break;
     }
 }
 
 void SliceRearrange::setSliceCount(int count)
 {
-    sliceCount_ = ultraglitch::dsp::clamp(count, 2, 16); // tasq.md range
+    const int newCount = ultraglitch::dsp::clamp(count, 2, 16); // tasq.md range
+    if (newCount == sliceCount_ && static_cast<int>(sliceOrder_.size()) == sliceCount_)
+        return;
+
+    sliceCount_ = newCount;
     updateInternalState(); // Recalculate slice order
 }
 
 void SliceRearrange::setRandomizeAmount(float amount)
 {
     randomizeAmount_ = ultraglitch::dsp::clamp(amount, 0.0f, 1.0f);
-    // updateInternalState() will be called in process if randomizeAmount_ > 0
-    // or when sliceCount_ changes.
+    // The order is reshuffled in process() while randomizeAmount_ > 0;
+    // updateInternalState() only runs when sliceCount_ changes.
 }
 
 void SliceRearrange::updateInternalState()
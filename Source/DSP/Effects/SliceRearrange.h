@@ -10,18 +10,21 @@
 
 namespace ultraglitch::dsp
 {
-class SliceRearrange : public ultraglitch::dsp::EffectBase
+class SliceRearrange final : public ultraglitch::dsp::EffectBase
 {
 public:
-    SliceRearrange();
+    // pluginParameters may be nullptr (effect then keeps its defaults until set explicitly)
+    explicit SliceRearrange(const PluginParameters* pluginParameters = nullptr);
     ~SliceRearrange() override = default;
 
     void prepare(double sampleRate, int maxBlockSize) override;
     void process(juce::AudioBuffer<float>& buffer) override;
+    void process(juce::AudioBuffer<double>& buffer) override;
     void reset() override;
+    [[nodiscard]] int getTailSamples() const override;
 
     // Parameter setter from PluginParameters/EffectChain
-    void setParameterValue(const juce::String& paramID, float value) override;
+    void setParameterValue(ultraglitch::params::ParamIndex index, float value) override;
 
     // Specific parameter setters (internal, might be called by setParameterValue)
     void setSliceCount(int count); // srSliceCount (2-16)
@@ -30,8 +33,26 @@ public:
     [[nodiscard]] juce::String getName() const override { return "SliceRearrange"; }
 
 private:
+    // Window audio, one pair per precision (see PrecisionStates)
+    template <typename SampleType>
+    struct WindowBuffers
+    {
+        juce::AudioBuffer<SampleType> captureBuffer;  // Window being filled from the input
+        juce::AudioBuffer<SampleType> playbackBuffer; // Previous window, rearranged, being played
+    };
+
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer);
+
     void updateInternalState(); // Method to recalculate slice sizes and order
 
+    template <typename SampleType>
+    void rearrangeCapturedWindow(); // Builds the next playback window from the captured one
+
+    // Slicing window. 512 samples is the block size the effect was originally voiced on,
+    // back when it sliced whatever block the host sent.
+    static constexpr int WINDOW_SAMPLES = 512;
+
     // Parameters
     int sliceCount_ = 4; // srSliceCount (2-16)
     float randomizeAmount_ = 0.5f; // srRandomize (0-1)
@@ -40,11 +61,6 @@ private:
     double currentSampleRate_ = 0.0;
     int currentMaxBlockSize_ = 0;
 
-    // Buffer to hold entire block of audio for slicing
-    juce::AudioBuffer<float> blockBuffer_;
-    juce::AudioBuffer<float> dryBuffer_;       // Preallocated dry signal buffer
-    juce::AudioBuffer<float> processedBuffer_; // Preallocated rearranged output buffer
-
     // Order of slices to process
     std::vector<int> sliceOrder_; // Stores indices 0 to sliceCount_-1
 
@@ -52,8 +68,9 @@ private:
     std::mt19937 randomEngine_; // Standard Mersenne Twister engine
     juce::Random juceRandomGenerator_; // For more convenient JUCE random functions if needed
 
-    // Internal state for block-based processing
-    int samplesAccumulated_ = 0; // Samples accumulated for the current blockBuffer_
+    // Internal state for window-based processing
+    PrecisionStates<WindowBuffers> windows_;
+    int samplesAccumulated_ = 0; // Samples accumulated for the current window
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SliceRearrange)
 };
@@ -1,16 +1,25 @@
 #include "WeirdFlanger.h"
 #include "../../Common/DSPUtils.h"
 #include "../../Common/ParameterIDs.h"
+#include "../../Common/PluginConfig.h"
 #include <cmath>
+#include <limits>
 
 namespace ultraglitch::dsp
 {
 
-WeirdFlanger::WeirdFlanger()
+WeirdFlanger::WeirdFlanger(const PluginParameters* pluginParameters)
 {
     // Initialize base class members
     setEnabled(false); // Start disabled
     setMix(1.0f);      // Default to 100% wet
+
+    using ultraglitch::params::ParamIndex;
+    bindParameter(pluginParameters, ParamIndex::WeirdFlanger_Enabled);
+    bindParameter(pluginParameters, ParamIndex::WeirdFlanger_Rate);
+    bindParameter(pluginParameters, ParamIndex::WeirdFlanger_Depth);
+    bindParameter(pluginParameters, ParamIndex::WeirdFlanger_Feedback);
+    bindParameter(pluginParameters, ParamIndex::WeirdFlanger_Mix);
 }
 
 void WeirdFlanger::prepare(double sampleRate, int maxBlockSize)
@@ -21,120 +30,139 @@ void WeirdFlanger::prepare(double sampleRate, int maxBlockSize)
     // Calculate delay buffer size needed for MAX_DELAY_MS
     delayBufferSize_ = static_cast<int>(std::ceil(MAX_DELAY_MS * 0.001 * currentSampleRate_)) + 2; // +2 for interpolation
     
-    delayBuffer_.setSize(2, delayBufferSize_); // Stereo buffer
-    delayBuffer_.clear();
+    if (isPreparedFor<double>())
+    {
+        states_.get<double>().delayLine.prepare(getNumChannels(), delayBufferSize_ - 1);
+        states_.get<float>().delayLine.release();
+    }
+    else
+    {
+        states_.get<float>().delayLine.prepare(getNumChannels(), delayBufferSize_ - 1);
+        states_.get<double>().delayLine.release();
+    }
     
-    dryBuffer_.setSize(2, maxBlockSize); // Preallocate for stereo
+    depthSmoother_.prepare(sampleRate, maxBlockSize);
 
-    writePosition_ = 0;
-    lastFeedbackSample_ = 0.0f;
-    
     updateLFO(); // Calculate LFO increment based on current rate and sample rate
     reset();
 }
 
-void WeirdFlanger::process(juce::AudioBuffer<float>& buffer)
+template <typename SampleType>
+void WeirdFlanger::processSamples(juce::AudioBuffer<SampleType>& buffer)
 {
     // The EffectChain handles isEnabled() check, so we process if we get here.
+    auto& state = states_.get<SampleType>();
+    auto& delayLine = state.delayLine;
     const int numSamples = buffer.getNumSamples();
-    const int numChannels = buffer.getNumChannels();
+    const int numChannels = juce::jmin(buffer.getNumChannels(), delayLine.getNumChannels()); // As prepared by EffectChain
+
+    // Work on interleaved frames, so every step below runs across all channels at once
+    ScratchArena::Scope scratch(getScratchArena());
+    SampleType* frames = scratch.allocateInterleaved<SampleType>(numChannels, numSamples);
+    if (frames == nullptr)
+        return; // No scratch (not in a prepared EffectChain) or not prepared for this precision: pass through
+
+    ultraglitch::dsp::interleave_channels(buffer.getArrayOfReadPointers(), numChannels, 0, numSamples, frames);
+
+    // Smoothed depth (nullptr once settled)
+    const float* depthRamp = depthSmoother_.getNextBlock(numSamples);
 
-    // Guard: host may deliver blocks larger than maxBlockSize from prepare()
-    if (numSamples > dryBuffer_.getNumSamples() || numChannels > dryBuffer_.getNumChannels())
-        dryBuffer_.setSize(juce::jmax(numChannels, 2), numSamples, false, false, true);
+    // Control rate: the LFO is evaluated once per block, at its end, and the delay time
+    // ramps linearly from the previous block's value (EffectChain keeps blocks at
+    // config::INTERNAL_BLOCK_SIZE, short against the LFO period)
+    double endPhase = lfoPhase_ + lfoPhaseIncrement_ * numSamples;
+    endPhase -= std::floor(endPhase);
+    const float endDepth = depthRamp != nullptr ? depthRamp[numSamples - 1] : depth_;
+    const float endDelaySamples = getDelaySamples(endPhase, endDepth);
+    const float delayStep = (endDelaySamples - lastDelaySamples_) / static_cast<float>(numSamples);
 
-    // Copy input to dryBuffer_ for mixing later
-    for(int ch = 0; ch < numChannels; ++ch)
-        dryBuffer_.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+    SampleType* feedbackFrame = state.feedbackSamples.data(); // Last delayed frame, per channel
+    const auto feedback = static_cast<SampleType>(feedback_);
 
     for (int sampleIdx = 0; sampleIdx < numSamples; ++sampleIdx)
     {
-        // Generate LFO value (0.0 to 1.0)
-        float lfoValue = (std::sin(static_cast<float>(lfoPhase_) * juce::MathConstants<float>::twoPi) * 0.5f + 0.5f);
-        
-        // Modulate delay time
-        float minDelaySamples = MIN_DELAY_MS * 0.001f * static_cast<float>(currentSampleRate_);
-        float maxDelaySamples = MAX_DELAY_MS * 0.001f * static_cast<float>(currentSampleRate_);
-        
-        // Depth parameter controls the modulation range
-        float modulatedDelaySamples = minDelaySamples + (maxDelaySamples - minDelaySamples) * lfoValue * depth_;
-        
-        // Ensure delay is within bounds of the buffer
-        modulatedDelaySamples = ultraglitch::dsp::clamp(modulatedDelaySamples, 0.0f, static_cast<float>(delayBufferSize_ - 1));
+        SampleType* frame = frames + sampleIdx * numChannels; // Dry in, wet out (EffectChain mixes)
 
+        // Write the input plus each channel's own feedback to the delay line
+        SampleType* writeFrame = delayLine.getWriteFrame();
         for (int channel = 0; channel < numChannels; ++channel)
-        {
-            float inputSample = dryBuffer_.getSample(channel, sampleIdx); // Read from dry buffer for input
-            
-            // Add feedback to the input for the delay line
-            float inputWithFeedback = inputSample + lastFeedbackSample_ * feedback_; // lastFeedbackSample_ should be per channel
-
-            // This is incorrect for stereo. lastFeedbackSample_ should be an array or per-channel.
-            // For PoC, simplify to mono feedback, or handle per-channel feedback.
-            // For now, I'll use a single lastFeedbackSample_ which implies mono feedback.
-            
-            // Write inputWithFeedback to the delay line
-            delayBuffer_.setSample(channel, writePosition_, inputWithFeedback);
-            
-            // Read from the delay line with modulated delay time (linear interpolation)
-            int readPosition = writePosition_ - static_cast<int>(modulatedDelaySamples);
-            while (readPosition < 0) readPosition += delayBufferSize_;
-            
-            float delayedSample = ultraglitch::dsp::read_delay_line(delayBuffer_, channel, 
-                                                                    static_cast<float>(readPosition), 
-                                                                    delayBufferSize_);
-            
-            // Store feedback sample for next iteration
-            lastFeedbackSample_ = delayedSample; // This still implies mono feedback
-            
-            // Wet signal is the delayed sample
-            float wetSample = delayedSample;
-            
-            // Apply dry/wet mix from EffectBase
-            buffer.setSample(channel, sampleIdx, ultraglitch::dsp::mix(inputSample, wetSample, getMix()));
-        }
-        
-        // Advance write position
-        writePosition_ = (writePosition_ + 1) % delayBufferSize_;
-        
-        // Advance LFO phase
-        lfoPhase_ += lfoPhaseIncrement_;
-        if (lfoPhase_ >= 1.0)
-        {
-            lfoPhase_ -= 1.0;
-        }
+            writeFrame[channel] = frame[channel] + feedbackFrame[channel] * feedback;
+
+        // Read with the modulated delay time (linear interpolation); the wet signal is
+        // also next sample's feedback
+        delayLine.read(lastDelaySamples_ + delayStep * static_cast<float>(sampleIdx + 1), feedbackFrame);
+        delayLine.advance();
+
+        std::copy(feedbackFrame, feedbackFrame + numChannels, frame);
     }
+
+    ultraglitch::dsp::deinterleave_channels(frames, numChannels, numSamples, buffer.getArrayOfWritePointers(), 0);
+
+    lfoPhase_ = endPhase;
+    lastDelaySamples_ = endDelaySamples;
+}
+
+void WeirdFlanger::process(juce::AudioBuffer<float>& buffer)
+{
+    processSamples(buffer);
+}
+
+void WeirdFlanger::process(juce::AudioBuffer<double>& buffer)
+{
+    processSamples(buffer);
+}
+
+float WeirdFlanger::getDelaySamples(double phase, float depth) const
+{
+    // Sine LFO 0-1; depth scales how far the delay sweeps from MIN_DELAY_MS towards MAX_DELAY_MS
+    const float lfoValue = std::sin(static_cast<float>(phase) * juce::MathConstants<float>::twoPi) * 0.5f + 0.5f;
+    const float minDelaySamples = MIN_DELAY_MS * 0.001f * static_cast<float>(currentSampleRate_);
+    const float maxDelaySamples = MAX_DELAY_MS * 0.001f * static_cast<float>(currentSampleRate_);
+    const float modulatedDelaySamples = minDelaySamples + (maxDelaySamples - minDelaySamples) * lfoValue * depth;
+
+    // Ensure delay is within bounds of the buffer
+    return ultraglitch::dsp::clamp(modulatedDelaySamples, 0.0f, static_cast<float>(juce::jmax(0, delayBufferSize_ - 1)));
 }
 
 void WeirdFlanger::reset()
 {
-    delayBuffer_.clear();
-    writePosition_ = 0;
-    lastFeedbackSample_ = 0.0f;
+    states_.get<float>().delayLine.reset();
+    states_.get<float>().feedbackSamples.fill(0.0f);
+    states_.get<double>().delayLine.reset();
+    states_.get<double>().feedbackSamples.fill(0.0);
     lfoPhase_ = 0.0;
+    lastDelaySamples_ = getDelaySamples(lfoPhase_, depth_);
 }
 
-void WeirdFlanger::setParameterValue(const juce::String& paramID, float value)
+int WeirdFlanger::getTailSamples() const
 {
-    if (paramID == ultraglitch::params::WeirdFlanger_Enabled)
-    {
-        setEnabled(value > 0.5f);
-    }
-    else if (paramID == ultraglitch::params::WeirdFlanger_Rate)
-    {
-        setRate(value);
-    }
-    else if (paramID == ultraglitch::params::WeirdFlanger_Depth)
-    {
-        setDepth(value);
-    }
-    else if (paramID == ultraglitch::params::WeirdFlanger_Feedback)
-    {
-        setFeedback(value); // Param is -1..1, pass directly
-    }
-    else if (paramID == ultraglitch::params::WeirdFlanger_Mix)
+    // One trip through the delay line, plus the round trips feedback takes to decay
+    // below the silence threshold; at |feedback| = 1 it rings forever
+    const float feedbackGain = std::abs(feedback_);
+
+    if (feedbackGain >= 1.0f)
+        return std::numeric_limits<int>::max();
+
+    double roundTrips = 1.0;
+    if (feedbackGain > ultraglitch::config::SILENCE_THRESHOLD)
+        roundTrips += std::ceil(std::log(static_cast<double>(ultraglitch::config::SILENCE_THRESHOLD)) / std::log(static_cast<double>(feedbackGain)));
+
+    return static_cast<int>(juce::jmin(static_cast<double>(std::numeric_limits<int>::max()),
+                                       roundTrips * static_cast<double>(delayBufferSize_)));
+}
+
+void WeirdFlanger::setParameterValue(ultraglitch::params::ParamIndex index, float value)
+{
+    using ultraglitch::params::ParamIndex;
+
+    switch (index)
     {
-        setMix(value); // Param is 0..1, pass directly
+        case ParamIndex::WeirdFlanger_Enabled:  setEnabled(value > 0.5f); break;
+        case ParamIndex::WeirdFlanger_Rate:     setRate(value); break;
+        case ParamIndex::WeirdFlanger_Depth:    setDepth(value); break;
+        case ParamIndex::WeirdFlanger_Feedback: setFeedback(value); break; // Param is -1..1, pass directly
+        case ParamIndex::WeirdFlanger_Mix:      setMix(value); break; // Param is 0..1, pass directly
+        default: break;
     }
 }
 
@@ -147,6 +175,7 @@ void WeirdFlanger::setRate(float rateHz)
 void WeirdFlanger::setDepth(float depth)
 {
     depth_ = ultraglitch::dsp::clamp(depth, 0.0f, 1.0f); // tasq.md implies 0-1
+    depthSmoother_.setTargetValue(depth_);
 }
 
 void WeirdFlanger::setFeedback(float feedback)
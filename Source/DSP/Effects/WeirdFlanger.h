@@ -3,23 +3,29 @@
 #include "../EffectBase.h" // Points to ultraglitch::dsp::EffectBase
 #include "../../Common/DSPUtils.h" // Points to ultraglitch::dsp::DSPUtils
 #include "../../Common/ParameterIDs.h" // For parameter IDs
+#include "../../Common/PluginConfig.h" // For MAX_NUM_CHANNELS
+#include "../FrameDelayLine.h"
 #include <juce_dsp/juce_dsp.h> // For juce::dsp::DelayLine or other dsp utilities
 #include <juce_audio_basics/juce_audio_basics.h> // For juce::AudioBuffer
+#include <array>
 
 namespace ultraglitch::dsp
 {
-class WeirdFlanger : public ultraglitch::dsp::EffectBase
+class WeirdFlanger final : public ultraglitch::dsp::EffectBase
 {
 public:
-    WeirdFlanger();
+    // pluginParameters may be nullptr (effect then keeps its defaults until set explicitly)
+    explicit WeirdFlanger(const PluginParameters* pluginParameters = nullptr);
     ~WeirdFlanger() override = default;
 
     void prepare(double sampleRate, int maxBlockSize) override;
     void process(juce::AudioBuffer<float>& buffer) override;
+    void process(juce::AudioBuffer<double>& buffer) override;
     void reset() override;
+    [[nodiscard]] int getTailSamples() const override;
 
     // Parameter setter from PluginParameters/EffectChain
-    void setParameterValue(const juce::String& paramID, float value) override;
+    void setParameterValue(ultraglitch::params::ParamIndex index, float value) override;
 
     // Specific parameter setters (internal, might be called by setParameterValue)
     void setRate(float rateHz); // wfRate (Hz)
@@ -29,12 +35,27 @@ public:
     [[nodiscard]] juce::String getName() const override { return "WeirdFlanger"; }
 
 private:
+    // Sample state, one per precision (see PrecisionStates)
+    template <typename SampleType>
+    struct FlangerState
+    {
+        FrameDelayLine<SampleType> delayLine; // All channels per frame
+
+        // Last sample from the delay line per channel, fed back into the next write
+        std::array<SampleType, ultraglitch::config::MAX_NUM_CHANNELS> feedbackSamples {};
+    };
+
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer);
+
     void updateLFO(); // Method to update LFO rate and phase increment
+    float getDelaySamples(double phase, float depth) const; // Delay time at an LFO phase
 
     // Parameters
     float rate_ = 1.0f; // LFO rate in Hz
     float depth_ = 0.5f; // LFO depth (modulates delay time range)
     float feedback_ = 0.0f; // Feedback amount (-1.0 to 1.0)
+    ParameterSmoother depthSmoother_; // Ramps depth_ so the delay sweep doesn't jump
 
     double currentSampleRate_ = 0.0;
     int currentMaxBlockSize_ = 0;
@@ -42,15 +63,12 @@ private:
     // LFO state
     double lfoPhase_ = 0.0;
     double lfoPhaseIncrement_ = 0.0;
+    float lastDelaySamples_ = 0.0f; // Delay at the end of the previous block (ramp start)
 
     // Delay line for flanger effect
-    juce::AudioBuffer<float> delayBuffer_; // Manual circular buffer
-    int delayBufferSize_ = 0;
-    int writePosition_ = 0;
-
-    float lastFeedbackSample_ = 0.0f; // Stores the last sample from the delay line for feedback
+    PrecisionStates<FlangerState> states_;
+    int delayBufferSize_ = 0; // Frames the longest delay spans
 
-    juce::AudioBuffer<float> dryBuffer_; // Preallocated buffer for dry signal
 
     // Flanger specific constants
     static constexpr float MIN_DELAY_MS = 0.5f; // Min delay in milliseconds
@@ -0,0 +1,36 @@
+#include "FrameDelayLine.h"
+#include <algorithm>
+
+namespace ultraglitch::dsp
+{
+
+template <typename SampleType>
+void FrameDelayLine<SampleType>::prepare(int numChannels, int maxDelaySamples)
+{
+    numChannels_ = juce::jmax(1, numChannels);
+    numFrames_ = juce::jmax(0, maxDelaySamples) + 2; // Newest frame plus the interpolation partner
+    data_.assign(static_cast<size_t>(numFrames_) * static_cast<size_t>(numChannels_), SampleType(0));
+    writeFrame_ = 0;
+}
+
+template <typename SampleType>
+void FrameDelayLine<SampleType>::reset()
+{
+    std::fill(data_.begin(), data_.end(), SampleType(0));
+    writeFrame_ = 0;
+}
+
+template <typename SampleType>
+void FrameDelayLine<SampleType>::release()
+{
+    data_.clear();
+    data_.shrink_to_fit();
+    numChannels_ = 0;
+    numFrames_ = 2;
+    writeFrame_ = 0;
+}
+
+template class FrameDelayLine<float>;
+template class FrameDelayLine<double>;
+
+} // namespace ultraglitch::dsp
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <juce_core/juce_core.h> // For jassert
+#include <vector>
+
+namespace ultraglitch::dsp
+{
+/**
+    Multichannel delay line stored frame by frame: the samples of all channels for one
+    time step sit next to each other. Per-sample kernels then touch one contiguous frame
+    per read or write, and their loops over channels vectorize (4 channels per SSE/NEON
+    register, 8 per AVX) instead of walking one ring per channel.
+
+    prepare()/reset() on the message thread (or while stopped); the rest is audio thread.
+    Instantiated for float and double.
+*/
+template <typename SampleType>
+class FrameDelayLine
+{
+public:
+    FrameDelayLine() = default;
+
+    // Room for delays up to maxDelaySamples (fractional delays need one frame more)
+    void prepare(int numChannels, int maxDelaySamples);
+    void reset();
+    void release(); // Frees the history; getNumChannels() is 0 until the next prepare()
+
+    [[nodiscard]] int getNumChannels() const { return numChannels_; }
+    [[nodiscard]] int getMaxDelaySamples() const { return numFrames_ - 2; }
+
+    // Frame for the current time step; fill it before reading, then advance()
+    SampleType* getWriteFrame() noexcept { return data_.data() + static_cast<size_t>(writeFrame_) * static_cast<size_t>(numChannels_); }
+
+    // Linearly interpolated frame delaySamples behind the current write frame (0 = itself)
+    void read(float delaySamples, SampleType* frame) const noexcept
+    {
+        jassert(delaySamples >= 0.0f && delaySamples <= static_cast<float>(getMaxDelaySamples()));
+
+        const int wholeDelay = static_cast<int>(delaySamples);
+        const auto fraction = static_cast<SampleType>(delaySamples - static_cast<float>(wholeDelay));
+
+        int newer = writeFrame_ - wholeDelay;
+        if (newer < 0)
+            newer += numFrames_;
+        const int older = newer > 0 ? newer - 1 : numFrames_ - 1;
+
+        const SampleType* a = data_.data() + static_cast<size_t>(newer) * static_cast<size_t>(numChannels_);
+        const SampleType* b = data_.data() + static_cast<size_t>(older) * static_cast<size_t>(numChannels_);
+
+        for (int ch = 0; ch < numChannels_; ++ch)
+            frame[ch] = a[ch] + fraction * (b[ch] - a[ch]);
+    }
+
+    void advance() noexcept
+    {
+        if (++writeFrame_ == numFrames_)
+            writeFrame_ = 0;
+    }
+
+private:
+    std::vector<SampleType> data_; // numFrames_ x numChannels_, frame-major
+    int numChannels_ = 0;
+    int numFrames_ = 2;
+    int writeFrame_ = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FrameDelayLine)
+};
+} // namespace ultraglitch::dsp
@@ -0,0 +1,278 @@
+#include "InternalRateConverter.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ultraglitch::dsp
+{
+
+namespace
+{
+    // Half-lengths (M: 4M - 1 taps, 2M of them non-zero besides the centre). With the Kaiser
+    // window below both reach about 80 dB; 32 puts the transition band of the stage next to
+    // 44.1 kHz between 20 and 24.1 kHz, 8 is plenty where the band to clear starts octaves up.
+    constexpr int INNER_HALF_LENGTH = 32;
+    constexpr int OUTER_HALF_LENGTH = 8;
+    constexpr double KAISER_BETA = 8.0;
+
+    // Modified Bessel function of the first kind, order 0 (power series)
+    double besselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+
+        for (int k = 1; k < 50 && term > sum * 1.0e-12; ++k)
+        {
+            const double factor = x / (2.0 * k);
+            term *= factor * factor;
+            sum += term;
+        }
+
+        return sum;
+    }
+}
+
+template <typename SampleType>
+void InternalRateConverter<SampleType>::prepare(int numChannels, int factor, int maxBlockSize)
+{
+    numStages_ = 0;
+    while ((2 << numStages_) <= factor && numStages_ < MAX_STAGES)
+        ++numStages_;
+
+    jassert(factor == getFactor()); // Powers of two only
+
+    numChannels_ = numStages_ > 0 ? juce::jmax(1, numChannels) : 0;
+    maxBlockSize_ = numStages_ > 0 ? juce::jmax(1, maxBlockSize) : 0;
+    latencySamples_ = 0;
+
+    for (int s = MAX_STAGES - 1; s >= 0; --s)
+    {
+        auto& stage = stages_[static_cast<size_t>(s)];
+
+        if (s >= numStages_)
+        {
+            prepareStage(stage, 0); // Frees it
+            stageBuffers_[static_cast<size_t>(s + 1)].setSize(0, 0);
+            continue;
+        }
+
+        // Each stage sees the rest of the cascade as a delay at its own output rate
+        const int halfLength = s == numStages_ - 1 ? INNER_HALF_LENGTH : OUTER_HALF_LENGTH;
+        prepareStage(stage, halfLength);
+        latencySamples_ = 2 * (2 * halfLength - 1) + 2 * latencySamples_;
+
+        stageBuffers_[static_cast<size_t>(s + 1)].setSize(numChannels_, (maxBlockSize_ >> (s + 1)) + 1);
+    }
+
+    reset();
+}
+
+template <typename SampleType>
+void InternalRateConverter<SampleType>::prepareStage(Stage& stage, int halfLength)
+{
+    stage.halfLength = halfLength;
+    const int taps = 2 * halfLength;
+    const size_t channels = static_cast<size_t>(halfLength > 0 ? numChannels_ : 0);
+
+    stage.coefficients.assign(static_cast<size_t>(taps), SampleType(0));
+    stage.downHistory.assign(channels * static_cast<size_t>(2 * taps), SampleType(0));
+    stage.upHistory.assign(channels * static_cast<size_t>(2 * taps), SampleType(0));
+    stage.downCentre.assign(channels * static_cast<size_t>(halfLength), SampleType(0));
+    stage.upHeld.assign(channels, SampleType(0));
+
+    if (halfLength == 0)
+    {
+        for (auto* v : { &stage.coefficients, &stage.downHistory, &stage.upHistory, &stage.downCentre, &stage.upHeld })
+            v->shrink_to_fit();
+        return;
+    }
+
+    // Windowed sinc at a quarter of the high rate: taps 2i lie an odd distance from the
+    // centre, so (tap - centre) / 2 is a half-integer and none of them is zero
+    const double centre = 2.0 * halfLength - 1.0;
+    double sum = 0.0;
+    std::vector<double> taps64(static_cast<size_t>(taps));
+
+    for (int i = 0; i < taps; ++i)
+    {
+        const double offset = 2.0 * i - centre;
+        const double x = juce::MathConstants<double>::pi * offset * 0.5;
+        const double ratio = offset / centre;
+        const double window = besselI0(KAISER_BETA * std::sqrt(juce::jmax(0.0, 1.0 - ratio * ratio))) / besselI0(KAISER_BETA);
+        taps64[static_cast<size_t>(i)] = 0.5 * std::sin(x) / x * window;
+        sum += taps64[static_cast<size_t>(i)];
+    }
+
+    // Unity gain at DC: the off-centre taps sum to 0.5, the centre tap is 0.5
+    for (int i = 0; i < taps; ++i)
+        stage.coefficients[static_cast<size_t>(i)] = static_cast<SampleType>(taps64[static_cast<size_t>(i)] * 0.5 / sum);
+}
+
+template <typename SampleType>
+void InternalRateConverter<SampleType>::reset()
+{
+    for (auto& stage : stages_)
+    {
+        std::fill(stage.downHistory.begin(), stage.downHistory.end(), SampleType(0));
+        std::fill(stage.upHistory.begin(), stage.upHistory.end(), SampleType(0));
+        std::fill(stage.downCentre.begin(), stage.downCentre.end(), SampleType(0));
+        std::fill(stage.upHeld.begin(), stage.upHeld.end(), SampleType(0));
+        stage.historyPosition = 0;
+        stage.upPosition = 0;
+        stage.centrePosition = 0;
+        stage.phase = 0;
+        stage.blockStartPhase = 0;
+    }
+}
+
+template <typename SampleType>
+int InternalRateConverter<SampleType>::downsample(const juce::AudioBuffer<SampleType>& input, int startSample, int numSamples)
+{
+    jassert(numStages_ > 0 && numSamples <= maxBlockSize_);
+    jassert(input.getNumChannels() >= numChannels_); // The prepared channel count
+
+    const SampleType* const* source = input.getArrayOfReadPointers();
+    int sourceStart = startSample;
+    int count = juce::jmin(numSamples, maxBlockSize_);
+
+    for (int s = 0; s < numStages_; ++s)
+    {
+        auto& destination = stageBuffers_[static_cast<size_t>(s + 1)];
+        stageBlockSizes_[static_cast<size_t>(s)] = count;
+        count = downsampleStage(stages_[static_cast<size_t>(s)], source, sourceStart, count,
+                                destination.getArrayOfWritePointers());
+        source = destination.getArrayOfReadPointers();
+        sourceStart = 0;
+    }
+
+    return count;
+}
+
+template <typename SampleType>
+void InternalRateConverter<SampleType>::upsample(juce::AudioBuffer<SampleType>& output, int startSample, int numSamples)
+{
+    jassert(numStages_ > 0 && numSamples == stageBlockSizes_[0]);
+    juce::ignoreUnused(numSamples);
+
+    // Innermost stage first; each writes the block of its input rate that downsample() read
+    for (int s = numStages_ - 1; s >= 0; --s)
+    {
+        const int stageSamples = stageBlockSizes_[static_cast<size_t>(s)];
+        SampleType* const* destination = s == 0 ? output.getArrayOfWritePointers()
+                                                : stageBuffers_[static_cast<size_t>(s)].getArrayOfWritePointers();
+
+        upsampleStage(stages_[static_cast<size_t>(s)], stageBuffers_[static_cast<size_t>(s + 1)].getArrayOfReadPointers(),
+                      destination, s == 0 ? startSample : 0, stageSamples);
+    }
+}
+
+template <typename SampleType>
+int InternalRateConverter<SampleType>::downsampleStage(Stage& stage, const SampleType* const* input, int startSample,
+                                                       int numSamples, SampleType* const* output)
+{
+    const int halfLength = stage.halfLength;
+    const int taps = 2 * halfLength;
+    const SampleType* coefficients = stage.coefficients.data();
+    const SampleType half = SampleType(0.5);
+
+    stage.blockStartPhase = stage.phase;
+
+    int position = stage.historyPosition;
+    int centrePosition = stage.centrePosition;
+    int produced = 0;
+
+    // Channel by channel from the same state; the last one's end state is everyone's
+    for (int ch = 0; ch < numChannels_; ++ch)
+    {
+        const SampleType* in = input[ch] + startSample;
+        SampleType* out = output[ch];
+        SampleType* history = stage.downHistory.data() + static_cast<size_t>(ch) * static_cast<size_t>(2 * taps);
+        SampleType* centre = stage.downCentre.data() + static_cast<size_t>(ch) * static_cast<size_t>(halfLength);
+
+        position = stage.historyPosition;
+        centrePosition = stage.centrePosition;
+        produced = 0;
+        int phase = stage.blockStartPhase;
+
+        for (int i = 0; i < numSamples; ++i, phase ^= 1)
+        {
+            if (phase == 0)
+            {
+                // Even input only ever meets the centre tap: a delay of M of them
+                centre[centrePosition] = in[i];
+                centrePosition = centrePosition + 1 == halfLength ? 0 : centrePosition + 1;
+                continue;
+            }
+
+            history[position] = in[i];
+            history[position + taps] = in[i];
+            const SampleType* window = history + position + 1; // Newest 2M odd inputs, contiguous
+            position = position + 1 == taps ? 0 : position + 1;
+
+            SampleType sum = half * centre[centrePosition]; // Oldest slot = input 2M - 1 back
+            for (int k = 0; k < taps; ++k)
+                sum += coefficients[k] * window[k];
+
+            out[produced++] = sum;
+        }
+    }
+
+    stage.historyPosition = position;
+    stage.centrePosition = centrePosition;
+    stage.phase = (stage.blockStartPhase + numSamples) & 1;
+    return produced;
+}
+
+template <typename SampleType>
+void InternalRateConverter<SampleType>::upsampleStage(Stage& stage, const SampleType* const* input, SampleType* const* output,
+                                                      int startSample, int numSamples)
+{
+    const int halfLength = stage.halfLength;
+    const int taps = 2 * halfLength;
+    const SampleType* coefficients = stage.coefficients.data();
+    const SampleType gain = SampleType(2); // Zero stuffing halves the level
+
+    int position = stage.upPosition;
+
+    for (int ch = 0; ch < numChannels_; ++ch)
+    {
+        const SampleType* in = input[ch];
+        SampleType* out = output[ch] + startSample;
+        SampleType* history = stage.upHistory.data() + static_cast<size_t>(ch) * static_cast<size_t>(2 * taps);
+        SampleType held = stage.upHeld[static_cast<size_t>(ch)];
+
+        position = stage.upPosition;
+        int consumed = 0;
+        int phase = stage.blockStartPhase; // Same instants the decimator produced at
+
+        for (int i = 0; i < numSamples; ++i, phase ^= 1)
+        {
+            if (phase == 0)
+            {
+                out[i] = held; // Odd polyphase branch: the centre tap alone, a pure delay
+                continue;
+            }
+
+            history[position] = in[consumed];
+            history[position + taps] = in[consumed];
+            ++consumed;
+            const SampleType* window = history + position + 1;
+            position = position + 1 == taps ? 0 : position + 1;
+
+            SampleType sum = SampleType(0);
+            for (int k = 0; k < taps; ++k)
+                sum += coefficients[k] * window[k];
+
+            out[i] = gain * sum;
+            held = window[halfLength]; // Input M - 1 back, out on the next step
+        }
+
+        stage.upHeld[static_cast<size_t>(ch)] = held;
+    }
+
+    stage.upPosition = position;
+}
+
+template class InternalRateConverter<float>;
+template class InternalRateConverter<double>;
+
+} // namespace ultraglitch::dsp
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <vector>
+
+namespace ultraglitch::dsp
+{
+/**
+    Down/up conversion between the host rate and a lower internal rate, by a power-of-two
+    factor (a cascade of 2x half-band stages).
+
+    Each stage is a linear-phase half-band FIR (Kaiser window) split into its polyphase
+    branches: the decimator only computes the samples it keeps, the interpolator never
+    multiplies the zeros it stuffs in. Half the taps of a half-band filter are zero and the
+    centre tap is a plain delay, so every output costs one contiguous dot product, which
+    vectorizes. The stage next to the internal rate gets the long filter (its transition band
+    sits around the internal Nyquist); outer stages only have to clear the upper octaves.
+
+    downsample() and upsample() alternate, one pair per host block (of at most the prepared
+    size): downsample() fills getInternalBuffer(), which the caller processes in place, and
+    upsample() turns exactly that many internal samples back into the host block. The round
+    trip is a pure delay of getLatencySamples() host samples for band-limited material.
+
+    prepare() on the message thread (or while stopped); the rest is audio thread.
+    Instantiated for float and double.
+*/
+template <typename SampleType>
+class InternalRateConverter
+{
+public:
+    static constexpr int MAX_STAGES = 3; // Factor 8
+
+    InternalRateConverter() = default;
+
+    // factor is 1 (pass-through, frees everything) or a power of two up to 2^MAX_STAGES
+    void prepare(int numChannels, int factor, int maxBlockSize);
+    void reset();
+
+    [[nodiscard]] int getFactor() const { return 1 << numStages_; }
+    [[nodiscard]] int getLatencySamples() const { return latencySamples_; } // Host samples, down + up
+    [[nodiscard]] int getMaxBlockSize() const { return maxBlockSize_; }
+
+    // Host block in, internal samples out (returned count, in getInternalBuffer())
+    int downsample(const juce::AudioBuffer<SampleType>& input, int startSample, int numSamples);
+    juce::AudioBuffer<SampleType>& getInternalBuffer() { return stageBuffers_[static_cast<size_t>(numStages_)]; }
+
+    // Internal samples from the last downsample() back into the same host range
+    void upsample(juce::AudioBuffer<SampleType>& output, int startSample, int numSamples);
+
+private:
+    struct Stage
+    {
+        int halfLength = 0;                   // M: 2M even-index taps, centre tap at 2M - 1
+        std::vector<SampleType> coefficients; // The 2M non-zero off-centre taps (symmetric)
+
+        // Per channel, 2M samples each: doubled rings, so the newest 2M are contiguous
+        std::vector<SampleType> downHistory;  // Odd-phase input
+        std::vector<SampleType> upHistory;    // Low-rate input
+        std::vector<SampleType> downCentre;   // Even-phase input, M per channel (centre tap delay)
+        std::vector<SampleType> upHeld;       // Odd output waiting for the next high-rate step
+        int historyPosition = 0;
+        int upPosition = 0;
+        int centrePosition = 0;
+
+        int phase = 0;           // Parity of the next high-rate sample (1 = a low-rate sample is due)
+        int blockStartPhase = 0; // Phase at the start of the last downsample(), replayed by upsample()
+    };
+
+    void prepareStage(Stage& stage, int halfLength);
+    int downsampleStage(Stage& stage, const SampleType* const* input, int startSample, int numSamples,
+                        SampleType* const* output);
+    void upsampleStage(Stage& stage, const SampleType* const* input, SampleType* const* output,
+                       int startSample, int numSamples);
+
+    std::array<Stage, MAX_STAGES> stages_;
+    std::array<juce::AudioBuffer<SampleType>, MAX_STAGES + 1> stageBuffers_; // [s]: rate / 2^s; [0] unused
+    std::array<int, MAX_STAGES> stageBlockSizes_ {}; // Input samples each stage took in the last downsample()
+    int numStages_ = 0;
+    int numChannels_ = 0;
+    int maxBlockSize_ = 0;
+    int latencySamples_ = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(InternalRateConverter)
+};
+} // namespace ultraglitch::dsp
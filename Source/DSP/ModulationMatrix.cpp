@@ -0,0 +1,446 @@
+#include "ModulationMatrix.h"
+#include "../Common/DSPUtils.h"
+#include "../Parameters/ParameterRegistry.h"
+#include <cmath>
+#include <limits>
+
+namespace ultraglitch::dsp
+{
+
+namespace
+{
+    constexpr float MIN_RATE_HZ = 0.01f;
+    constexpr float MAX_RATE_HZ = 20.0f;
+    constexpr float ENVELOPE_ATTACK_MS = 5.0f;
+    constexpr float ENVELOPE_RELEASE_MS = 150.0f;
+
+    constexpr std::array<float, ModulationMatrix::NUM_SOURCES> DEFAULT_RATES_HZ = {
+        1.0f,  // LfoSine
+        0.5f,  // LfoTriangle
+        4.0f,  // LfoSampleHold
+        0.25f, // Random
+        0.0f   // EnvelopeFollower (no phase)
+    };
+
+    float bipolarRandom(juce::Random& random)
+    {
+        return random.nextFloat() * 2.0f - 1.0f;
+    }
+}
+
+const juce::Identifier ModulationMatrix::STATE_TYPE { "ModulationMatrix" };
+
+ModulationMatrix::ModulationMatrix()
+    : randomGenerator_(RANDOM_SEED)
+{
+    rateHz_ = DEFAULT_RATES_HZ;
+    messageRateHz_ = DEFAULT_RATES_HZ;
+    lastApplied_.fill(std::numeric_limits<float>::quiet_NaN()); // Never equal: first value is always emitted
+}
+
+void ModulationMatrix::prepare(double sampleRate)
+{
+    sampleRate_ = sampleRate;
+
+    // Playback is stopped, so adopt the message-thread copy directly; this also
+    // recovers edits dropped while the command FIFO was full
+    commandFifo_.reset();
+    audioRoutes_ = routes_;
+    rateHz_ = messageRateHz_;
+    rebuildDestinations();
+    refreshDestinations_ |= activeDestinations_;
+
+    const auto tickSeconds = static_cast<float>(ultraglitch::config::MODULATION_CONTROL_INTERVAL_SAMPLES / sampleRate_);
+    envelopeAttack_ = std::exp(-tickSeconds / (ENVELOPE_ATTACK_MS * 0.001f));
+    envelopeRelease_ = std::exp(-tickSeconds / (ENVELOPE_RELEASE_MS * 0.001f));
+
+    updatePhaseIncrements();
+    reset();
+}
+
+void ModulationMatrix::reset()
+{
+    controlCounter_ = 0;
+    phase_.fill(0.0f);
+    value_.fill(0.0f);
+    envelopePeak_ = 0.0f;
+
+    randomGenerator_.setSeed(RANDOM_SEED); // Same sequence on every playback/bounce
+    randomFrom_ = 0.0f;
+    randomTo_ = bipolarRandom(randomGenerator_);
+}
+
+void ModulationMatrix::applyPendingCommands()
+{
+    const auto scope = commandFifo_.read(commandFifo_.getNumReady());
+
+    for (int i = 0; i < scope.blockSize1; ++i)
+        applyCommand(commands_[static_cast<size_t>(scope.startIndex1 + i)]);
+
+    for (int i = 0; i < scope.blockSize2; ++i)
+        applyCommand(commands_[static_cast<size_t>(scope.startIndex2 + i)]);
+}
+
+int ModulationMatrix::getSamplesUntilNextTick() const
+{
+    if (activeDestinations_ == 0)
+        return std::numeric_limits<int>::max();
+
+    return ultraglitch::config::MODULATION_CONTROL_INTERVAL_SAMPLES - controlCounter_;
+}
+
+template <typename SampleType>
+void ModulationMatrix::process(const juce::AudioBuffer<SampleType>& input, int startSample, int numSamples)
+{
+    if (activeDestinations_ == 0)
+        return;
+
+    if (usesEnvelope_)
+    {
+        for (int ch = 0; ch < input.getNumChannels(); ++ch)
+            envelopePeak_ = juce::jmax(envelopePeak_, static_cast<float>(input.getMagnitude(ch, startSample, numSamples)));
+    }
+
+    // Sub-blocks are cut at ticks, so this normally ticks at most once
+    controlCounter_ += numSamples;
+    while (controlCounter_ >= ultraglitch::config::MODULATION_CONTROL_INTERVAL_SAMPLES)
+    {
+        controlCounter_ -= ultraglitch::config::MODULATION_CONTROL_INTERVAL_SAMPLES;
+        tick();
+    }
+}
+
+template void ModulationMatrix::process<float>(const juce::AudioBuffer<float>&, int, int);
+template void ModulationMatrix::process<double>(const juce::AudioBuffer<double>&, int, int);
+
+void ModulationMatrix::tick()
+{
+    constexpr auto sine = static_cast<size_t>(ModulationSource::LfoSine);
+    constexpr auto triangle = static_cast<size_t>(ModulationSource::LfoTriangle);
+    constexpr auto sampleHold = static_cast<size_t>(ModulationSource::LfoSampleHold);
+    constexpr auto random = static_cast<size_t>(ModulationSource::Random);
+    constexpr auto envelope = static_cast<size_t>(ModulationSource::EnvelopeFollower);
+
+    // One pass advances every phase lane (the envelope lane's increment is 0)
+    juce::FloatVectorOperations::add(phase_.data(), phaseIncrement_.data(), NUM_SOURCES);
+
+    std::array<bool, NUM_SOURCES> wrapped {};
+    for (size_t i = 0; i < phase_.size(); ++i)
+    {
+        wrapped[i] = phase_[i] >= 1.0f;
+        if (wrapped[i])
+            phase_[i] -= std::floor(phase_[i]);
+    }
+
+    value_[sine] = std::sin(juce::MathConstants<float>::twoPi * phase_[sine]);
+
+    // Triangle in phase with the sine: 0 -> 1 -> 0 -> -1 -> 0
+    const float trianglePhase = phase_[triangle] + 0.25f;
+    value_[triangle] = 1.0f - 4.0f * std::abs(trianglePhase - std::floor(trianglePhase) - 0.5f);
+
+    if (wrapped[sampleHold])
+        value_[sampleHold] = bipolarRandom(randomGenerator_);
+
+    if (wrapped[random])
+    {
+        randomFrom_ = randomTo_;
+        randomTo_ = bipolarRandom(randomGenerator_);
+    }
+    value_[random] = randomFrom_ + (randomTo_ - randomFrom_) * phase_[random];
+
+    if (usesEnvelope_)
+    {
+        const float coefficient = envelopePeak_ > value_[envelope] ? envelopeAttack_ : envelopeRelease_;
+        value_[envelope] = juce::jmin(1.0f, envelopePeak_ + coefficient * (value_[envelope] - envelopePeak_));
+        envelopePeak_ = 0.0f;
+    }
+}
+
+ultraglitch::params::ParamMask ModulationMatrix::computeModulatedValues(const std::array<float, ultraglitch::params::NUM_PARAMETERS>& baseValues,
+                                                                       std::array<float, ultraglitch::params::NUM_PARAMETERS>& modulatedValues,
+                                                                       ultraglitch::params::ParamMask forceMask)
+{
+    using namespace ultraglitch::params;
+
+    if (numRoutes_ > 0)
+    {
+        // Gather each route's source, then scale by all depths in one pass
+        for (int r = 0; r < numRoutes_; ++r)
+            routeScratch_[static_cast<size_t>(r)] = value_[static_cast<size_t>(routeSource_[static_cast<size_t>(r)])];
+
+        juce::FloatVectorOperations::multiply(routeScratch_.data(), routeDepth_.data(), numRoutes_);
+
+        for (auto bits = activeDestinations_; bits != 0; bits &= bits - 1)
+            offsets_[static_cast<size_t>(lowest_set_index(bits))] = 0.0f;
+
+        for (int r = 0; r < numRoutes_; ++r)
+            offsets_[static_cast<size_t>(routeDestination_[static_cast<size_t>(r)])] += routeScratch_[static_cast<size_t>(r)];
+    }
+
+    ParamMask emitted = 0;
+
+    for (auto bits = activeDestinations_ | refreshDestinations_; bits != 0; bits &= bits - 1)
+    {
+        const auto index = lowest_set_index(bits);
+        const auto i = static_cast<size_t>(index);
+        const auto bit = to_mask(index);
+        float value = baseValues[i];
+
+        if ((activeDestinations_ & bit) != 0)
+        {
+            const auto& spec = get_parameter_spec(index);
+            value = ultraglitch::dsp::clamp(value + offsets_[i] * (spec.maxValue - spec.minValue), spec.minValue, spec.maxValue);
+
+            // Stepped parameters (bit depth, toggles, ...) move in the same steps the host uses
+            if (spec.stepValue > 0.0f)
+                value = spec.minValue + std::round((value - spec.minValue) / spec.stepValue) * spec.stepValue;
+        }
+
+        if (value != lastApplied_[i] || ((forceMask | refreshDestinations_) & bit) != 0)
+        {
+            modulatedValues[i] = value;
+            lastApplied_[i] = value;
+            emitted |= bit;
+        }
+    }
+
+    refreshDestinations_ = 0;
+    return emitted;
+}
+
+void ModulationMatrix::setRoute(int slot, const ModulationRoute& route)
+{
+    if (slot < 0 || slot >= MAX_ROUTES)
+        return;
+
+    routes_[static_cast<size_t>(slot)] = route;
+
+    Command command;
+    command.type = Command::Type::SetRoute;
+    command.slot = slot;
+    command.route = route;
+    postCommand(command);
+}
+
+ModulationRoute ModulationMatrix::getRoute(int slot) const
+{
+    if (slot < 0 || slot >= MAX_ROUTES)
+        return {};
+
+    return routes_[static_cast<size_t>(slot)];
+}
+
+void ModulationMatrix::setSourceRate(ModulationSource source, float rateHz)
+{
+    if (source == ModulationSource::EnvelopeFollower || source == ModulationSource::Count)
+        return;
+
+    const auto i = static_cast<size_t>(source);
+    messageRateHz_[i] = ultraglitch::dsp::clamp(rateHz, MIN_RATE_HZ, MAX_RATE_HZ);
+
+    Command command;
+    command.type = Command::Type::SetRate;
+    command.slot = static_cast<int>(source);
+    command.rateHz = messageRateHz_[i];
+    postCommand(command);
+}
+
+float ModulationMatrix::getSourceRate(ModulationSource source) const
+{
+    if (source == ModulationSource::Count)
+        return 0.0f;
+
+    return messageRateHz_[static_cast<size_t>(source)];
+}
+
+juce::ValueTree ModulationMatrix::createState() const
+{
+    juce::ValueTree state(STATE_TYPE);
+
+    for (int i = 0; i < NUM_SOURCES; ++i)
+    {
+        if (static_cast<ModulationSource>(i) == ModulationSource::EnvelopeFollower)
+            continue;
+
+        juce::ValueTree source("Source");
+        source.setProperty("Index", i, nullptr);
+        source.setProperty("Rate", messageRateHz_[static_cast<size_t>(i)], nullptr);
+        state.appendChild(source, nullptr);
+    }
+
+    for (int slot = 0; slot < MAX_ROUTES; ++slot)
+    {
+        const auto& route = routes_[static_cast<size_t>(slot)];
+        if (!route.isActive())
+            continue;
+
+        // Destinations are stored by parameter ID so reordering ParamIndex keeps old sessions valid
+        juce::ValueTree routeTree("Route");
+        routeTree.setProperty("Slot", slot, nullptr);
+        routeTree.setProperty("Source", static_cast<int>(route.source), nullptr);
+        routeTree.setProperty("Destination", ultraglitch::params::to_juce_string(ultraglitch::params::get_parameter_spec(route.destination).id), nullptr);
+        routeTree.setProperty("Depth", route.depth, nullptr);
+        state.appendChild(routeTree, nullptr);
+    }
+
+    return state;
+}
+
+void ModulationMatrix::restoreState(const juce::ValueTree& state)
+{
+    std::array<ModulationRoute, MAX_ROUTES> routes {};
+
+    if (state.isValid() && state.hasType(STATE_TYPE))
+    {
+        for (int i = 0; i < state.getNumChildren(); ++i)
+        {
+            const auto child = state.getChild(i);
+
+            if (child.hasType("Source"))
+            {
+                const int index = child.getProperty("Index", -1);
+                if (index >= 0 && index < NUM_SOURCES)
+                    setSourceRate(static_cast<ModulationSource>(index),
+                                  child.getProperty("Rate", DEFAULT_RATES_HZ[static_cast<size_t>(index)]));
+            }
+            else if (child.hasType("Route"))
+            {
+                const int slot = child.getProperty("Slot", -1);
+                const int source = child.getProperty("Source", -1);
+                const auto* spec = ultraglitch::params::find_parameter_spec(child.getProperty("Destination").toString().toRawUTF8());
+
+                if (slot < 0 || slot >= MAX_ROUTES || source < 0 || source >= NUM_SOURCES || spec == nullptr)
+                    continue;
+
+                auto& route = routes[static_cast<size_t>(slot)];
+                route.source = static_cast<ModulationSource>(source);
+                route.destination = spec->index;
+                route.depth = ultraglitch::dsp::clamp(static_cast<float>(child.getProperty("Depth", 0.0f)), -1.0f, 1.0f);
+            }
+        }
+    }
+
+    // Every slot is rewritten, so routes missing from the state are cleared
+    for (int slot = 0; slot < MAX_ROUTES; ++slot)
+        setRoute(slot, routes[static_cast<size_t>(slot)]);
+}
+
+void ModulationMatrix::postCommand(const Command& command)
+{
+    const auto scope = commandFifo_.write(1);
+
+    // Full only if playback is stopped or hundreds of edits arrive within one block;
+    // prepare() resyncs from the message-thread copy
+    if (scope.blockSize1 == 0)
+        return;
+
+    commands_[static_cast<size_t>(scope.startIndex1)] = command;
+}
+
+void ModulationMatrix::applyCommand(const Command& command)
+{
+    switch (command.type)
+    {
+        case Command::Type::SetRoute:
+        {
+            const auto previous = audioRoutes_[static_cast<size_t>(command.slot)];
+            audioRoutes_[static_cast<size_t>(command.slot)] = command.route;
+
+            if (previous.isActive())
+                refreshDestinations_ |= ultraglitch::params::to_mask(previous.destination);
+            if (command.route.isActive())
+                refreshDestinations_ |= ultraglitch::params::to_mask(command.route.destination);
+
+            rebuildDestinations();
+            break;
+        }
+        case Command::Type::SetRate:
+            rateHz_[static_cast<size_t>(command.slot)] = command.rateHz;
+            updatePhaseIncrements();
+            break;
+    }
+}
+
+void ModulationMatrix::updatePhaseIncrements()
+{
+    const auto tickSeconds = static_cast<float>(ultraglitch::config::MODULATION_CONTROL_INTERVAL_SAMPLES / sampleRate_);
+    juce::FloatVectorOperations::copyWithMultiply(phaseIncrement_.data(), rateHz_.data(), tickSeconds, NUM_SOURCES);
+    phaseIncrement_[static_cast<size_t>(ModulationSource::EnvelopeFollower)] = 0.0f;
+}
+
+void ModulationMatrix::rebuildDestinations()
+{
+    // Pack active routes into the SoA arrays computeModulatedValues() walks
+    numRoutes_ = 0;
+    activeDestinations_ = 0;
+    usesEnvelope_ = false;
+
+    for (const auto& route : audioRoutes_)
+    {
+        if (!route.isActive())
+            continue;
+
+        const auto r = static_cast<size_t>(numRoutes_++);
+        routeSource_[r] = static_cast<int>(route.source);
+        routeDestination_[r] = static_cast<int>(route.destination);
+        routeDepth_[r] = route.depth;
+
+        activeDestinations_ |= ultraglitch::params::to_mask(route.destination);
+        usesEnvelope_ = usesEnvelope_ || route.source == ModulationSource::EnvelopeFollower;
+    }
+}
+
+} // namespace ultraglitch::dsp
+
+#if JUCE_UNIT_TESTS
+
+namespace ultraglitch::dsp
+{
+
+class ModulationMatrixTests : public juce::UnitTest
+{
+public:
+    ModulationMatrixTests() : juce::UnitTest("ModulationMatrix", "UltraGlitch") {}
+
+    void runTest() override
+    {
+        using namespace ultraglitch::params;
+
+        constexpr auto target = ParamIndex::BitCrusher_Mix; // 0..1, default 0
+        constexpr auto i = static_cast<size_t>(target);
+
+        std::array<float, NUM_PARAMETERS> baseValues{};
+        std::array<float, NUM_PARAMETERS> modulatedValues{};
+        for (const auto& spec : PARAMETER_REGISTRY)
+            baseValues[static_cast<size_t>(spec.index)] = spec.defaultValue;
+
+        beginTest("A route moves its destination");
+        ModulationMatrix matrix;
+        matrix.setRoute(0, { ModulationSource::LfoSine, target, 0.5f });
+        matrix.prepare(48000.0);
+        expect(matrix.isActive());
+
+        // A quarter period of the default 1 Hz sine: the source is at +1
+        juce::AudioBuffer<float> silence(1, 12000);
+        silence.clear();
+        matrix.process(silence, 0, silence.getNumSamples());
+
+        auto emitted = matrix.computeModulatedValues(baseValues, modulatedValues, 0);
+        expect(emitted == to_mask(target)); // Only the destination moves
+        expectWithinAbsoluteError(modulatedValues[i], 0.5f, 0.02f);
+
+        beginTest("Clearing the route restores the base value");
+        matrix.clearRoute(0);
+        matrix.applyPendingCommands();
+        emitted = matrix.computeModulatedValues(baseValues, modulatedValues, 0);
+        expect(emitted == to_mask(target));
+        expectEquals(modulatedValues[i], baseValues[i]);
+        expect(!matrix.isActive());
+    }
+};
+
+static ModulationMatrixTests modulationMatrixTests;
+
+} // namespace ultraglitch::dsp
+
+#endif
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h> // For juce::AudioBuffer, juce::FloatVectorOperations
+#include <juce_data_structures/juce_data_structures.h> // For juce::ValueTree
+#include <array>
+#include "../Common/ParameterIDs.h"
+#include "../Common/PluginConfig.h"
+
+namespace ultraglitch::dsp
+{
+enum class ModulationSource : int
+{
+    LfoSine = 0,
+    LfoTriangle,
+    LfoSampleHold,
+    Random,           // Smoothed random walk (deterministic seed)
+    EnvelopeFollower, // Peak follower on the chain input, 0..1
+
+    Count
+};
+
+struct ModulationRoute
+{
+    ModulationSource source = ModulationSource::LfoSine;
+    ultraglitch::params::ParamIndex destination = ultraglitch::params::ParamIndex::Count; // Count = unused slot
+    float depth = 0.0f; // -1..1, fraction of the destination's range per unit of source
+
+    [[nodiscard]] bool isActive() const
+    {
+        return destination != ultraglitch::params::ParamIndex::Count && depth != 0.0f;
+    }
+
+    [[nodiscard]] bool operator==(const ModulationRoute& other) const
+    {
+        return source == other.source && destination == other.destination && depth == other.depth;
+    }
+
+    [[nodiscard]] bool operator!=(const ModulationRoute& other) const { return !(*this == other); }
+};
+
+/**
+    Control-rate modulation matrix: a few sources mapped onto any ParamIndex.
+
+    Sources are stored SoA and all advance together every
+    MODULATION_CONTROL_INTERVAL_SAMPLES (each tick is a sub-block change point).
+    Modulated values are base value + sum(depth * source * range), handed to the
+    owning effects by EffectChain without touching the APVTS.
+
+    Route edits come from the message thread through a wait-free command FIFO;
+    the message thread also keeps its own copy of the routes for state saving.
+*/
+class ModulationMatrix
+{
+public:
+    static constexpr int NUM_SOURCES = static_cast<int>(ModulationSource::Count);
+    static constexpr int MAX_ROUTES = 16;
+    static constexpr juce::int64 RANDOM_SEED = 0x6d6f64756c617465;
+
+    ModulationMatrix();
+
+    // Audio thread (or before playback)
+    void prepare(double sampleRate);
+    void reset(); // Restarts phases and the random sequence
+    void applyPendingCommands();
+
+    [[nodiscard]] bool isActive() const { return activeDestinations_ != 0 || refreshDestinations_ != 0; }
+    [[nodiscard]] int getSamplesUntilNextTick() const;
+
+    // Tracks the input envelope and advances sources by numSamples (ticks on the control grid).
+    // Instantiated for float and double input.
+    template <typename SampleType>
+    void process(const juce::AudioBuffer<SampleType>& input, int startSample, int numSamples);
+
+    // Writes base + modulation into modulatedValues for destinations whose value changed
+    // (or are in forceMask, e.g. their base was just re-applied raw) and returns their
+    // mask. Destinations a route edit touched are always emitted once, so a destination
+    // that lost its last route gets its base value back.
+    ultraglitch::params::ParamMask computeModulatedValues(const std::array<float, ultraglitch::params::NUM_PARAMETERS>& baseValues,
+                                                          std::array<float, ultraglitch::params::NUM_PARAMETERS>& modulatedValues,
+                                                          ultraglitch::params::ParamMask forceMask);
+
+    // Message thread
+    void setRoute(int slot, const ModulationRoute& route);
+    void clearRoute(int slot) { setRoute(slot, {}); }
+    [[nodiscard]] ModulationRoute getRoute(int slot) const;
+    void setSourceRate(ModulationSource source, float rateHz); // LFOs and Random
+    [[nodiscard]] float getSourceRate(ModulationSource source) const;
+
+    [[nodiscard]] juce::ValueTree createState() const;
+    void restoreState(const juce::ValueTree& state);
+    static const juce::Identifier STATE_TYPE;
+
+private:
+    struct Command
+    {
+        enum class Type { SetRoute, SetRate } type = Type::SetRoute;
+        int slot = 0; // Route slot or source index
+        ModulationRoute route;
+        float rateHz = 0.0f;
+    };
+
+    void postCommand(const Command& command);
+    void applyCommand(const Command& command);
+    void tick();
+    void updatePhaseIncrements();
+    void rebuildDestinations();
+
+    double sampleRate_ = ultraglitch::config::DEFAULT_SAMPLE_RATE;
+    int controlCounter_ = 0;
+
+    // Sources, SoA (one lane per ModulationSource)
+    std::array<float, NUM_SOURCES> rateHz_{};
+    std::array<float, NUM_SOURCES> phase_{};
+    std::array<float, NUM_SOURCES> phaseIncrement_{}; // Per control tick
+    std::array<float, NUM_SOURCES> value_{};
+    float randomFrom_ = 0.0f;
+    float randomTo_ = 0.0f;
+    float envelopePeak_ = 0.0f; // Input peak since the last tick
+    float envelopeAttack_ = 1.0f;
+    float envelopeRelease_ = 1.0f;
+    juce::Random randomGenerator_;
+
+    // Routes, SoA (audio thread copy)
+    std::array<int, MAX_ROUTES> routeSource_{};
+    std::array<int, MAX_ROUTES> routeDestination_{};
+    std::array<float, MAX_ROUTES> routeDepth_{};
+    std::array<float, MAX_ROUTES> routeScratch_{};
+    int numRoutes_ = 0;
+    std::array<ModulationRoute, MAX_ROUTES> audioRoutes_{};
+
+    ultraglitch::params::ParamMask activeDestinations_ = 0;
+    ultraglitch::params::ParamMask refreshDestinations_ = 0; // Touched by a route edit, emit once
+    bool usesEnvelope_ = false;
+    std::array<float, ultraglitch::params::NUM_PARAMETERS> offsets_{};
+    std::array<float, ultraglitch::params::NUM_PARAMETERS> lastApplied_{};
+
+    // Message thread side
+    std::array<ModulationRoute, MAX_ROUTES> routes_{};
+    std::array<float, NUM_SOURCES> messageRateHz_{};
+    juce::AbstractFifo commandFifo_ { 64 };
+    std::array<Command, 64> commands_{};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulationMatrix)
+};
+} // namespace ultraglitch::dsp
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h> // For juce::dsp::Oversampling
+#include <array>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include "EffectBase.h"
+#include "ScratchArena.h"
+#include "../Common/PluginConfig.h"
+
+namespace ultraglitch::dsp
+{
+/**
+    Effect run at 2x, 4x or 8x the chain's sample rate, for effects whose nonlinearities
+    (quantization, saturating feedback) fold back below Nyquist at 1x.
+
+    process() upsamples the block, runs the wrapped effect's process() on it and filters it
+    back down (juce::dsp::Oversampling: a cascade of polyphase half-band stages). The effect
+    is prepared at the oversampled rate and block size, so its time constants, own
+    smoothers and scratch needs stay right, and sees getOversamplingFactor() for anything
+    it counts in samples. Realtime playback uses the low-latency half-band IIRs at the
+    realtime factor; offline rendering (isNonRealtime()) the linear-phase FIRs at the
+    offline factor. Either way the latency is a whole number of samples, fixed until the
+    next prepare().
+
+    The effect is a member, so it stays final and its process() is called directly. This
+    wrapper binds the same parameters and forwards them; the effect's enable and mix
+    follow into the wrapper, where EffectChain reads them (the mix is blended at 1x, around
+    the whole round trip). An oversampled effect goes into EffectChain::addEffect()
+    wherever Effect did; getEffect() reaches the effect itself.
+*/
+template <typename Effect>
+class OversampledEffect final : public EffectBase
+{
+public:
+    static_assert(std::is_base_of_v<EffectBase, Effect>, "OversampledEffect wraps an EffectBase");
+
+    template <typename... Args>
+    explicit OversampledEffect(Args&&... args) : effect_(std::forward<Args>(args)...)
+    {
+        bindParametersOf(effect_); // The chain dispatches the effect's parameters to this wrapper
+        setEnabled(effect_.isEnabled());
+        setMix(effect_.getMix());
+    }
+
+    Effect& getEffect() { return effect_; }
+    const Effect& getEffect() const { return effect_; }
+
+    // 1, 2, 4 or 8 (rounded up to the next of those); applied at the next prepare()
+    void setOversamplingFactors(int realtimeFactor, int offlineFactor)
+    {
+        realtimeFactor_ = toValidFactor(realtimeFactor);
+        offlineFactor_ = toValidFactor(offlineFactor);
+    }
+
+    [[nodiscard]] int getRealtimeFactor() const { return realtimeFactor_; }
+    [[nodiscard]] int getOfflineFactor() const { return offlineFactor_; }
+
+    void prepare(double sampleRate, int maxBlockSize) override
+    {
+        const bool offline = isNonRealtime();
+        const int factor = offline ? offlineFactor_ : realtimeFactor_;
+        const int oversampledBlockSize = maxBlockSize * factor;
+
+        latencySamples_ = 0;
+        prepareOversampler<float>(factor, maxBlockSize, offline);
+        prepareOversampler<double>(factor, maxBlockSize, offline);
+
+        // What the chain set on this wrapper, at the oversampled rate. The chain's scratch
+        // is sized for 1x blocks, so the effect gets its own.
+        effect_.setNumChannels(getNumChannels());
+        effect_.setDoublePrecision(isDoublePrecision());
+        effect_.setNonRealtime(offline);
+        effect_.setOversamplingFactor(factor);
+        effect_.setScratchArena(&scratchArena_);
+        scratchArena_.prepare(getNumChannels(), oversampledBlockSize, MAX_SCRATCH_BUFFERS);
+
+        effect_.prepare(sampleRate * factor, oversampledBlockSize);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer) override { processSamples(buffer); }
+    void process(juce::AudioBuffer<double>& buffer) override { processSamples(buffer); }
+
+    void reset() override
+    {
+        effect_.reset();
+
+        if (auto& oversampler = oversamplers_.template get<float>())
+            oversampler->reset();
+        if (auto& oversampler = oversamplers_.template get<double>())
+            oversampler->reset();
+    }
+
+    [[nodiscard]] int getLatencySamples() const override { return latencySamples_; }
+
+    // The effect counts in oversampled samples; the chain in its own
+    [[nodiscard]] int getTailSamples() const override
+    {
+        const int tailSamples = effect_.getTailSamples();
+        if (tailSamples == std::numeric_limits<int>::max())
+            return tailSamples;
+
+        return toChainSamples(tailSamples) + latencySamples_;
+    }
+
+    [[nodiscard]] int getSamplesUntilNextChangePoint() const override
+    {
+        const int samples = effect_.getSamplesUntilNextChangePoint();
+        return samples == std::numeric_limits<int>::max() ? samples : toChainSamples(samples);
+    }
+
+    [[nodiscard]] bool canSleep() const override { return effect_.canSleep(); }
+    [[nodiscard]] juce::String getName() const override { return effect_.getName(); }
+
+    void setParameterValue(ultraglitch::params::ParamIndex index, float value) override
+    {
+        // The chain may have bypassed this wrapper since; the effect applies the value on
+        // top of the current state, and its enable and mix come back here
+        effect_.setEnabled(isEnabled());
+        effect_.setMix(getMix());
+        effect_.setParameterValue(index, value);
+        setEnabled(effect_.isEnabled());
+        setMix(effect_.getMix());
+    }
+
+    void collectParameterChanges(const std::array<float, ultraglitch::params::NUM_PARAMETERS>& currentValues,
+                                 GeneratedParameterChanges& changes) override
+    {
+        effect_.collectParameterChanges(currentValues, changes);
+    }
+
+private:
+    // Effects allocate at most this many buffers from the scratch arena at once
+    static constexpr int MAX_SCRATCH_BUFFERS = 2;
+
+    template <typename SampleType>
+    using OversamplerPtr = std::unique_ptr<juce::dsp::Oversampling<SampleType>>;
+
+    static int toValidFactor(int factor)
+    {
+        return juce::jlimit(1, ultraglitch::config::MAX_OVERSAMPLING_FACTOR, juce::nextPowerOfTwo(factor));
+    }
+
+    int toChainSamples(int samples) const
+    {
+        const int factor = effect_.getOversamplingFactor();
+        return samples / factor + (samples % factor != 0 ? 1 : 0);
+    }
+
+    // Builds the oversampler for the precision in use (nullptr at 1x and for the other one)
+    template <typename SampleType>
+    void prepareOversampler(int factor, int maxBlockSize, bool linearPhase)
+    {
+        auto& oversampler = oversamplers_.template get<SampleType>();
+
+        if (factor == 1 || ! isPreparedFor<SampleType>())
+        {
+            oversampler.reset();
+            return;
+        }
+
+        int numStages = 0;
+        while ((1 << numStages) < factor)
+            ++numStages;
+
+        using Oversampling = juce::dsp::Oversampling<SampleType>;
+        oversampler = std::make_unique<Oversampling>(static_cast<size_t>(getNumChannels()),
+                                                     static_cast<size_t>(numStages),
+                                                     linearPhase ? Oversampling::filterHalfBandFIREquiripple
+                                                                 : Oversampling::filterHalfBandPolyphaseIIR,
+                                                     true,  // Max quality: steeper, longer filters
+                                                     true); // Integer latency (host compensation)
+        oversampler->initProcessing(static_cast<size_t>(maxBlockSize));
+        latencySamples_ = juce::roundToInt(oversampler->getLatencyInSamples());
+    }
+
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer)
+    {
+        auto& oversampler = oversamplers_.template get<SampleType>();
+
+        if (oversampler == nullptr) // 1x, or not the prepared precision (the effect asserts)
+        {
+            effect_.process(buffer);
+            return;
+        }
+
+        juce::dsp::AudioBlock<SampleType> block(buffer);
+        auto oversampledBlock = oversampler->processSamplesUp(block);
+
+        // The oversampled block as a non-owning AudioBuffer for the effect
+        const int numChannels = juce::jmin(static_cast<int>(oversampledBlock.getNumChannels()),
+                                           ultraglitch::config::MAX_NUM_CHANNELS);
+        std::array<SampleType*, ultraglitch::config::MAX_NUM_CHANNELS> channels {};
+        for (int ch = 0; ch < numChannels; ++ch)
+            channels[static_cast<size_t>(ch)] = oversampledBlock.getChannelPointer(static_cast<size_t>(ch));
+
+        juce::AudioBuffer<SampleType> oversampledBuffer(channels.data(), numChannels,
+                                                        static_cast<int>(oversampledBlock.getNumSamples()));
+
+        effect_.process(oversampledBuffer);
+
+        oversampler->processSamplesDown(block);
+    }
+
+    Effect effect_;
+    int realtimeFactor_ = ultraglitch::config::DEFAULT_OVERSAMPLING_FACTOR_REALTIME;
+    int offlineFactor_ = ultraglitch::config::DEFAULT_OVERSAMPLING_FACTOR_OFFLINE;
+    int latencySamples_ = 0;
+
+    PrecisionStates<OversamplerPtr> oversamplers_;
+    ScratchArena scratchArena_; // The effect's, sized for oversampled blocks
+};
+} // namespace ultraglitch::dsp
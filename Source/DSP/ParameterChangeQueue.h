@@ -0,0 +1,101 @@
+#pragma once
+
+#include <juce_core/juce_core.h> // For juce::AbstractFifo
+#include <vector>
+#include <array>
+#include "../Common/ParameterIDs.h"
+
+namespace ultraglitch::dsp
+{
+struct ParameterChange
+{
+    ultraglitch::params::ParamIndex index = ultraglitch::params::ParamIndex::Count;
+    float value = 0.0f; // Real (denormalized) value
+};
+
+// Parameter values an effect generated on the audio thread (see EffectBase::collectParameterChanges()).
+// What the DSP should use now and what the host should see can differ — a chaos morph
+// applies every glide step but only publishes its target.
+struct GeneratedParameterChanges
+{
+    std::array<float, ultraglitch::params::NUM_PARAMETERS> applyValues{};
+    ultraglitch::params::ParamMask applyMask = 0;
+
+    std::array<float, ultraglitch::params::NUM_PARAMETERS> publishValues{};
+    ultraglitch::params::ParamMask publishMask = 0;
+
+    // Parameters to hand back to their host value (re-read through the owner's ParameterHandle)
+    ultraglitch::params::ParamMask revertMask = 0;
+
+    // Chain order requests (chaos reorder): shuffle with orderSeed, or go back to the user order
+    enum class OrderRequest { None, Shuffle, Restore };
+    OrderRequest orderRequest = OrderRequest::None;
+    int orderSeed = 0;
+
+    void apply(ultraglitch::params::ParamIndex index, float value)
+    {
+        applyValues[static_cast<size_t>(index)] = value;
+        applyMask |= ultraglitch::params::to_mask(index);
+    }
+
+    void publish(ultraglitch::params::ParamIndex index, float value)
+    {
+        publishValues[static_cast<size_t>(index)] = value;
+        publishMask |= ultraglitch::params::to_mask(index);
+    }
+
+    void revert(ultraglitch::params::ParamIndex index)
+    {
+        revertMask |= ultraglitch::params::to_mask(index);
+    }
+};
+
+/**
+    Single-producer / single-consumer queue of parameter changes.
+
+    The audio thread pushes values it generated itself (e.g. chaos); the message
+    thread pops them and publishes them to the host. Wait-free on both sides and
+    allocation-free after construction. When full, push() drops the change — only
+    the host's view lags, the DSP already applied the value.
+*/
+class ParameterChangeQueue
+{
+public:
+    explicit ParameterChangeQueue(int capacity = 1024)
+        : fifo_(capacity), changes_(static_cast<size_t>(capacity))
+    {
+    }
+
+    bool push(ultraglitch::params::ParamIndex index, float value)
+    {
+        const auto scope = fifo_.write(1);
+        if (scope.blockSize1 == 0)
+            return false;
+
+        changes_[static_cast<size_t>(scope.startIndex1)] = { index, value };
+        return true;
+    }
+
+    // Copies up to maxChanges entries into dest and returns how many were copied
+    int pop(ParameterChange* dest, int maxChanges)
+    {
+        const auto scope = fifo_.read(maxChanges);
+
+        for (int i = 0; i < scope.blockSize1; ++i)
+            dest[i] = changes_[static_cast<size_t>(scope.startIndex1 + i)];
+
+        for (int i = 0; i < scope.blockSize2; ++i)
+            dest[scope.blockSize1 + i] = changes_[static_cast<size_t>(scope.startIndex2 + i)];
+
+        return scope.blockSize1 + scope.blockSize2;
+    }
+
+    void clear() { fifo_.reset(); } // Only when neither side is running
+
+private:
+    juce::AbstractFifo fifo_;
+    std::vector<ParameterChange> changes_;
+
+    JUCE_DECLARE_NON_COPYABLE(ParameterChangeQueue)
+};
+} // namespace ultraglitch::dsp
@@ -0,0 +1,95 @@
+#include "ParameterSmoother.h"
+
+namespace ultraglitch::dsp
+{
+
+void ParameterSmoother::prepare(double sampleRate, int maxBlockSize, float rampTimeMs)
+{
+    const int capacity = juce::jmax(1, maxBlockSize);
+
+    ramp_.assign(static_cast<size_t>(capacity), 0.0f);
+    rampIndex_.resize(static_cast<size_t>(capacity));
+    for (int i = 0; i < capacity; ++i)
+        rampIndex_[static_cast<size_t>(i)] = static_cast<float>(i + 1);
+
+    rampLengthSamples_ = juce::jmax(0, static_cast<int>(std::round(rampTimeMs * 0.001 * sampleRate)));
+    setCurrentAndTargetValue(targetValue_);
+}
+
+void ParameterSmoother::setTargetValue(float newTarget)
+{
+    if (newTarget == targetValue_)
+        return;
+
+    targetValue_ = newTarget;
+
+    if (rampLengthSamples_ <= 0)
+    {
+        setCurrentAndTargetValue(newTarget);
+        return;
+    }
+
+    samplesRemaining_ = rampLengthSamples_;
+    step_ = (targetValue_ - currentValue_) / static_cast<float>(rampLengthSamples_);
+}
+
+void ParameterSmoother::setCurrentAndTargetValue(float newValue)
+{
+    currentValue_ = newValue;
+    targetValue_ = newValue;
+    step_ = 0.0f;
+    samplesRemaining_ = 0;
+}
+
+const float* ParameterSmoother::getNextBlock(int numSamples)
+{
+    if (samplesRemaining_ <= 0 || numSamples <= 0)
+        return nullptr;
+
+    if (numSamples > static_cast<int>(ramp_.size()))
+    {
+        setCurrentAndTargetValue(targetValue_);
+        return nullptr;
+    }
+
+    float* ramp = ramp_.data();
+    const int rampSamples = juce::jmin(numSamples, samplesRemaining_);
+
+    // ramp[i] = current + step * (i + 1)
+    juce::FloatVectorOperations::copyWithMultiply(ramp, rampIndex_.data(), step_, rampSamples);
+    juce::FloatVectorOperations::add(ramp, currentValue_, rampSamples);
+
+    samplesRemaining_ -= rampSamples;
+
+    if (samplesRemaining_ == 0)
+    {
+        ramp[rampSamples - 1] = targetValue_; // Land exactly on target
+        currentValue_ = targetValue_;
+
+        if (rampSamples < numSamples)
+            juce::FloatVectorOperations::fill(ramp + rampSamples, targetValue_, numSamples - rampSamples);
+    }
+    else
+    {
+        currentValue_ = ramp[rampSamples - 1];
+    }
+
+    return ramp;
+}
+
+void ParameterSmoother::skip(int numSamples)
+{
+    if (samplesRemaining_ <= 0 || numSamples <= 0)
+        return;
+
+    if (numSamples >= samplesRemaining_)
+    {
+        setCurrentAndTargetValue(targetValue_);
+        return;
+    }
+
+    currentValue_ += step_ * static_cast<float>(numSamples);
+    samplesRemaining_ -= numSamples;
+}
+
+} // namespace ultraglitch::dsp
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h> // For juce::FloatVectorOperations
+#include <vector>
+#include "../Common/PluginConfig.h"
+
+namespace ultraglitch::dsp
+{
+/**
+    Linear parameter smoother that renders one ramp array per block.
+
+    Ramps are generated with juce::FloatVectorOperations (SIMD) from a
+    precomputed 1..N index table. Once the target is reached getNextBlock()
+    returns nullptr and costs nothing — callers then use getCurrentValue().
+    All methods are meant to be called from the audio thread, except prepare().
+*/
+class ParameterSmoother
+{
+public:
+    ParameterSmoother() = default;
+
+    /** Allocates the ramp buffers. Snaps the current value to the target. */
+    void prepare(double sampleRate, int maxBlockSize,
+                 float rampTimeMs = ultraglitch::config::PARAMETER_SMOOTHING_TIME_MS);
+
+    /** Starts a new ramp from the current value (snaps if not prepared yet). */
+    void setTargetValue(float newTarget);
+
+    /** Jumps immediately, cancelling any running ramp. */
+    void setCurrentAndTargetValue(float newValue);
+
+    /**
+        Advances the smoother by numSamples.
+        Returns a pointer to numSamples ramp values, or nullptr if the smoother
+        was already settled (or numSamples exceeds the prepared block size, in
+        which case it snaps to the target).
+    */
+    const float* getNextBlock(int numSamples);
+
+    /** Advances without rendering a ramp (e.g. when the consumer is bypassed). */
+    void skip(int numSamples);
+
+    [[nodiscard]] bool isSmoothing() const { return samplesRemaining_ > 0; }
+    [[nodiscard]] float getCurrentValue() const { return currentValue_; }
+    [[nodiscard]] float getTargetValue() const { return targetValue_; }
+
+private:
+    std::vector<float> ramp_;       // Output ramp for the current block
+    std::vector<float> rampIndex_;  // 1, 2, 3 ... maxBlockSize
+
+    float currentValue_ = 0.0f;
+    float targetValue_ = 0.0f;
+    float step_ = 0.0f;
+    int samplesRemaining_ = 0;
+    int rampLengthSamples_ = 0;
+};
+} // namespace ultraglitch::dsp
@@ -0,0 +1,92 @@
+#include "ScratchArena.h"
+#include <cstdint>
+
+namespace ultraglitch::dsp
+{
+
+void ScratchArena::prepare(int maxChannels, int maxSamples, int maxBuffers)
+{
+    maxSamples_ = juce::jmax(0, maxSamples);
+    capacity_ = static_cast<size_t>(juce::jmax(0, maxChannels)) * static_cast<size_t>(juce::jmax(0, maxBuffers))
+              * paddedChannelSize<double>(maxSamples_);
+    top_ = 0;
+
+    // Over-allocate by one alignment unit and round the base up
+    storage_.calloc(capacity_ + ALIGNMENT_FLOATS);
+    const auto address = reinterpret_cast<std::uintptr_t>(storage_.get());
+    const auto alignBytes = static_cast<std::uintptr_t>(ALIGNMENT_FLOATS * sizeof(float));
+    base_ = reinterpret_cast<float*>((address + alignBytes - 1) / alignBytes * alignBytes);
+}
+
+ScratchArena::Scope::Scope(ScratchArena* arena)
+    : arena_(arena), marker_(arena != nullptr ? arena->top_ : 0)
+{
+}
+
+ScratchArena::Scope::~Scope()
+{
+    if (arena_ != nullptr)
+        arena_->top_ = marker_;
+}
+
+template <typename SampleType>
+juce::AudioBuffer<SampleType> ScratchArena::Scope::allocate(int numChannels, int numSamples)
+{
+    if (arena_ == nullptr || numChannels <= 0 || numChannels > MAX_VIEW_CHANNELS
+        || numSamples <= 0 || numSamples > arena_->maxSamples_)
+    {
+        jassert(arena_ != nullptr); // Effect used outside an EffectChain?
+        return {};
+    }
+
+    const size_t channelSize = paddedChannelSize<SampleType>(numSamples);
+    const size_t required = channelSize * static_cast<size_t>(numChannels);
+
+    if (arena_->top_ + required > arena_->capacity_)
+    {
+        jassertfalse; // More simultaneous buffers than EffectChain reserved
+        return {};
+    }
+
+    std::array<SampleType*, MAX_VIEW_CHANNELS> channels {};
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        // Offsets are multiples of ALIGNMENT_FLOATS, so doubles stay aligned too
+        channels[static_cast<size_t>(ch)] = reinterpret_cast<SampleType*>(arena_->base_ + arena_->top_);
+        juce::FloatVectorOperations::clear(channels[static_cast<size_t>(ch)], numSamples);
+        arena_->top_ += channelSize;
+    }
+
+    // The referencing constructor copies the channel pointers into the buffer itself
+    return juce::AudioBuffer<SampleType>(channels.data(), numChannels, numSamples);
+}
+
+template <typename SampleType>
+SampleType* ScratchArena::Scope::allocateInterleaved(int numChannels, int numSamples)
+{
+    if (arena_ == nullptr || numChannels <= 0 || numSamples <= 0 || numSamples > arena_->maxSamples_)
+    {
+        jassert(arena_ != nullptr); // Effect used outside an EffectChain?
+        return nullptr;
+    }
+
+    const size_t required = paddedChannelSize<SampleType>(numChannels * numSamples);
+
+    if (arena_->top_ + required > arena_->capacity_)
+    {
+        jassertfalse; // More simultaneous buffers than EffectChain reserved
+        return nullptr;
+    }
+
+    auto* frames = reinterpret_cast<SampleType*>(arena_->base_ + arena_->top_);
+    juce::FloatVectorOperations::clear(frames, numChannels * numSamples);
+    arena_->top_ += required;
+    return frames;
+}
+
+template juce::AudioBuffer<float> ScratchArena::Scope::allocate<float>(int, int);
+template juce::AudioBuffer<double> ScratchArena::Scope::allocate<double>(int, int);
+template float* ScratchArena::Scope::allocateInterleaved<float>(int, int);
+template double* ScratchArena::Scope::allocateInterleaved<double>(int, int);
+
+} // namespace ultraglitch::dsp
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h> // For juce::AudioBuffer, juce::HeapBlock
+#include <array>
+
+namespace ultraglitch::dsp
+{
+/**
+    Per-chain scratch memory for effects' temporary (per-block) buffers.
+
+    One 64-byte aligned block, sized in EffectChain::prepareToPlay(), handed out
+    stack-like: a Scope remembers the top on construction, allocate() bumps it, and
+    the Scope's destructor pops everything it allocated. Every channel starts on its
+    own cache line. Since effects run one after another, they all reuse the same few
+    kilobytes, which stay hot in cache instead of one set of buffers per effect.
+
+    Audio thread only once prepared; allocate() never allocates system memory.
+*/
+class ScratchArena
+{
+public:
+    static constexpr int ALIGNMENT_FLOATS = 16; // 64 bytes
+    static constexpr int MAX_VIEW_CHANNELS = 32; // Same limit as a referencing juce::AudioBuffer
+
+    ScratchArena() = default;
+
+    // Room for maxBuffers simultaneous buffers of maxChannels x maxSamples, in either
+    // precision (message thread)
+    void prepare(int maxChannels, int maxSamples, int maxBuffers);
+
+    [[nodiscard]] int getMaxSamples() const { return maxSamples_; }
+
+    class Scope
+    {
+    public:
+        explicit Scope(ScratchArena* arena);
+        ~Scope();
+
+        // Cleared view of numChannels x numSamples, or an empty buffer (0 channels) if the
+        // arena is missing or exhausted — callers then leave their input untouched.
+        // SampleType is float or double (the arena is sized for double).
+        template <typename SampleType>
+        juce::AudioBuffer<SampleType> allocate(int numChannels, int numSamples);
+
+        // Cleared interleaved block of numSamples frames x numChannels (frame-major: the
+        // channels of one sample are adjacent), or nullptr like allocate(). Takes no more
+        // room than allocate(numChannels, numSamples).
+        template <typename SampleType>
+        SampleType* allocateInterleaved(int numChannels, int numSamples);
+
+    private:
+        ScratchArena* arena_;
+        size_t marker_ = 0;
+
+        JUCE_DECLARE_NON_COPYABLE(Scope)
+    };
+
+private:
+    // Floats taken by numSamples samples, rounded up to the alignment
+    template <typename SampleType = float>
+    static size_t paddedChannelSize(int numSamples)
+    {
+        const size_t floats = static_cast<size_t>(numSamples) * (sizeof(SampleType) / sizeof(float));
+        return (floats + ALIGNMENT_FLOATS - 1) / ALIGNMENT_FLOATS * ALIGNMENT_FLOATS;
+    }
+
+    juce::HeapBlock<float> storage_;
+    float* base_ = nullptr; // storage_ rounded up to the alignment
+    size_t capacity_ = 0;   // Floats from base_ (storage unit for both sample types)
+    size_t top_ = 0;
+    int maxSamples_ = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScratchArena)
+};
+} // namespace ultraglitch::dsp
@@ -0,0 +1,242 @@
+#include "TruePeakLimiter.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ultraglitch::dsp
+{
+
+namespace
+{
+    float decibelsToGain(float decibels)
+    {
+        return std::pow(10.0f, decibels / 20.0f);
+    }
+}
+
+template <typename SampleType>
+void TruePeakLimiter<SampleType>::prepare(int numChannels, double sampleRate, int maxBlockSize)
+{
+    jassert(sampleRate > 0.0);
+
+    numChannels_ = juce::jmax(1, numChannels);
+    maxBlockSize_ = juce::jmax(1, maxBlockSize);
+    lookaheadSamples_ = juce::jmax(1, juce::roundToInt(ultraglitch::config::LIMITER_LOOKAHEAD_MS * 0.001 * sampleRate));
+    latencySamples_ = lookaheadSamples_ + DETECTOR_DELAY;
+
+    ceiling_ = decibelsToGain(ceilingDb_);
+    releaseCoefficient_ = static_cast<float>(std::exp(-1.0 / (ultraglitch::config::LIMITER_RELEASE_MS * 0.001 * sampleRate)));
+
+    // Windowed sinc (Hann, zero from DETECTOR_DELAY either side of the centre on) at a
+    // quarter, half and three quarters of the way from the sample DETECTOR_DELAY back to the
+    // next one; unity gain at DC
+    for (int phase = 1; phase < OVERSAMPLING; ++phase)
+    {
+        auto& coefficients = phaseCoefficients_[static_cast<size_t>(phase - 1)];
+        const double centre = DETECTOR_DELAY - 1 + static_cast<double>(phase) / OVERSAMPLING;
+        double sum = 0.0;
+
+        for (int k = 0; k < INTERPOLATOR_TAPS; ++k)
+        {
+            const double x = k - centre;
+            const double sinc = x == 0.0 ? 1.0 : std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+            const double window = std::abs(x) < DETECTOR_DELAY
+                ? 0.5 * (1.0 + std::cos(juce::MathConstants<double>::pi * x / DETECTOR_DELAY))
+                : 0.0;
+            coefficients[static_cast<size_t>(k)] = static_cast<SampleType>(sinc * window);
+            sum += sinc * window;
+        }
+
+        for (auto& coefficient : coefficients)
+            coefficient = static_cast<SampleType>(coefficient / sum);
+    }
+
+    history_.assign(static_cast<size_t>(numChannels_ * 2 * INTERPOLATOR_TAPS), SampleType(0));
+    delayCapacity_ = juce::nextPowerOfTwo(latencySamples_ + maxBlockSize_);
+    delay_.assign(static_cast<size_t>(numChannels_) * static_cast<size_t>(delayCapacity_), SampleType(0));
+
+    peaks_.assign(static_cast<size_t>(maxBlockSize_), 0.0f);
+    gains_.assign(static_cast<size_t>(maxBlockSize_), SampleType(1));
+
+    // The held window is lookahead + 1 samples; one more slot for the sample being pushed
+    holdValues_.assign(static_cast<size_t>(lookaheadSamples_ + 2), 1.0f);
+    holdTimes_.assign(static_cast<size_t>(lookaheadSamples_ + 2), 0);
+    averageHistory_.assign(static_cast<size_t>(lookaheadSamples_ + 1), 1.0f);
+
+    reset();
+}
+
+template <typename SampleType>
+void TruePeakLimiter<SampleType>::release()
+{
+    numChannels_ = 0;
+    maxBlockSize_ = 0;
+    lookaheadSamples_ = 0;
+    latencySamples_ = 0;
+    delayCapacity_ = 0;
+
+    history_ = {};
+    delay_ = {};
+    peaks_ = {};
+    gains_ = {};
+    holdValues_ = {};
+    holdTimes_ = {};
+    averageHistory_ = {};
+}
+
+template <typename SampleType>
+void TruePeakLimiter<SampleType>::reset()
+{
+    std::fill(history_.begin(), history_.end(), SampleType(0));
+    std::fill(delay_.begin(), delay_.end(), SampleType(0));
+    historyPosition_ = 0;
+    delayWritePosition_ = 0;
+
+    holdHead_ = 0;
+    holdSize_ = 0;
+    sampleTime_ = 0;
+
+    std::fill(averageHistory_.begin(), averageHistory_.end(), 1.0f);
+    averageSum_ = static_cast<double>(averageHistory_.size());
+    averagePosition_ = 0;
+    envelope_ = 1.0f;
+}
+
+template <typename SampleType>
+void TruePeakLimiter<SampleType>::setCeilingDecibels(float ceilingDb)
+{
+    ceilingDb = juce::jmin(0.0f, ceilingDb);
+    if (ceilingDb == ceilingDb_)
+        return;
+
+    ceilingDb_ = ceilingDb;
+    ceiling_ = decibelsToGain(ceilingDb_);
+}
+
+template <typename SampleType>
+void TruePeakLimiter<SampleType>::process(juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples,
+                                          const float* inputGainRamp, float inputGain)
+{
+    jassert(isPrepared());
+    jassert(numSamples <= maxBlockSize_);
+    jassert(buffer.getNumChannels() <= numChannels_);
+
+    numSamples = juce::jmin(numSamples, maxBlockSize_);
+    if (numSamples <= 0)
+        return;
+
+    const int numChannels = juce::jmin(buffer.getNumChannels(), numChannels_);
+    const int delayMask = delayCapacity_ - 1;
+    int historyPosition = historyPosition_;
+
+    std::fill_n(peaks_.begin(), numSamples, 0.0f);
+
+    // Gain, lookahead delay and true-peak detection in one pass per channel
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        SampleType* data = buffer.getWritePointer(ch, startSample);
+        SampleType* delay = delay_.data() + static_cast<size_t>(ch) * static_cast<size_t>(delayCapacity_);
+        SampleType* history = history_.data() + static_cast<size_t>(ch * 2 * INTERPOLATOR_TAPS);
+        int writePosition = delayWritePosition_;
+        historyPosition = historyPosition_;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float gain = inputGainRamp != nullptr ? inputGainRamp[i] : inputGain;
+            const SampleType x = data[i] * static_cast<SampleType>(gain);
+
+            delay[writePosition] = x;
+            writePosition = (writePosition + 1) & delayMask;
+
+            history[historyPosition] = x;
+            history[historyPosition + INTERPOLATOR_TAPS] = x;
+            historyPosition = historyPosition + 1 == INTERPOLATOR_TAPS ? 0 : historyPosition + 1;
+
+            const SampleType* window = history + historyPosition; // Oldest first
+            SampleType peak = std::abs(window[DETECTOR_DELAY - 1]);
+
+            for (const auto& coefficients : phaseCoefficients_)
+            {
+                SampleType sum = SampleType(0);
+                for (int k = 0; k < INTERPOLATOR_TAPS; ++k)
+                    sum += coefficients[static_cast<size_t>(k)] * window[k];
+
+                peak = juce::jmax(peak, std::abs(sum));
+            }
+
+            peaks_[static_cast<size_t>(i)] = juce::jmax(peaks_[static_cast<size_t>(i)], static_cast<float>(peak));
+        }
+    }
+
+    computeGains(numSamples);
+
+    // The gained input from latencySamples_ back, scaled by the limiting gain
+    const int readPosition = (delayWritePosition_ - latencySamples_) & delayMask;
+    const int firstPart = juce::jmin(numSamples, delayCapacity_ - readPosition);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        SampleType* data = buffer.getWritePointer(ch, startSample);
+        const SampleType* delay = delay_.data() + static_cast<size_t>(ch) * static_cast<size_t>(delayCapacity_);
+
+        juce::FloatVectorOperations::copy(data, delay + readPosition, firstPart);
+        if (firstPart < numSamples)
+            juce::FloatVectorOperations::copy(data + firstPart, delay, numSamples - firstPart);
+
+        juce::FloatVectorOperations::multiply(data, gains_.data(), numSamples);
+    }
+
+    delayWritePosition_ = (delayWritePosition_ + numSamples) & delayMask;
+    historyPosition_ = historyPosition;
+}
+
+template <typename SampleType>
+void TruePeakLimiter<SampleType>::computeGains(int numSamples)
+{
+    const int holdCapacity = static_cast<int>(holdValues_.size());
+    const int holdLength = lookaheadSamples_ + 1;
+    const int averageLength = static_cast<int>(averageHistory_.size());
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float peak = peaks_[static_cast<size_t>(i)];
+        const float required = peak > ceiling_ ? ceiling_ / peak : 1.0f;
+        const juce::int64 time = sampleTime_++;
+
+        // Lowest required gain over the last holdLength samples: values behind the front only
+        // matter while they are lower than everything pushed after them
+        while (holdSize_ > 0)
+        {
+            const int back = (holdHead_ + holdSize_ - 1) % holdCapacity;
+            if (holdValues_[static_cast<size_t>(back)] < required)
+                break;
+            --holdSize_;
+        }
+
+        const int slot = (holdHead_ + holdSize_) % holdCapacity;
+        holdValues_[static_cast<size_t>(slot)] = required;
+        holdTimes_[static_cast<size_t>(slot)] = time;
+        ++holdSize_;
+
+        if (holdTimes_[static_cast<size_t>(holdHead_)] <= time - holdLength)
+        {
+            holdHead_ = (holdHead_ + 1) % holdCapacity;
+            --holdSize_;
+        }
+
+        // Down at once, back up at the release rate; the average below is the attack. Every
+        // sample it averages holds the gain a peak needs, so the peak comes out at or under it.
+        const float held = holdValues_[static_cast<size_t>(holdHead_)];
+        envelope_ = held < envelope_ ? held : held + releaseCoefficient_ * (envelope_ - held);
+
+        averageSum_ += static_cast<double>(envelope_) - averageHistory_[static_cast<size_t>(averagePosition_)];
+        averageHistory_[static_cast<size_t>(averagePosition_)] = envelope_;
+        averagePosition_ = averagePosition_ + 1 == averageLength ? 0 : averagePosition_ + 1;
+
+        gains_[static_cast<size_t>(i)] = static_cast<SampleType>(juce::jmin(1.0, averageSum_ / averageLength));
+    }
+}
+
+template class TruePeakLimiter<float>;
+template class TruePeakLimiter<double>;
+
+} // namespace ultraglitch::dsp
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <vector>
+#include "../Common/PluginConfig.h"
+
+namespace ultraglitch::dsp
+{
+/**
+    Lookahead limiter that keeps true peaks (4x oversampled, as in ITU-R BS.1770) under a
+    ceiling, with the output gain applied on the way in.
+
+    process() scales the block by the input gain while it writes it to the lookahead delay
+    and to the peak detector, so gain and limiting are one pass over the audio. The
+    detector interpolates three points between every two samples (a 64-tap polyphase FIR,
+    16 contiguous taps per phase) and keeps the largest magnitude per sample across all
+    channels, so every channel gets the same gain. The gain computer holds the lowest gain
+    needed over the lookahead, releases exponentially and averages over the lookahead, so
+    the gain has reached its target when the peak comes out. Output is the gained input
+    getLatencySamples() earlier.
+
+    prepare() on the message thread (or while stopped); the rest is audio thread.
+    Instantiated for float and double.
+*/
+template <typename SampleType>
+class TruePeakLimiter
+{
+public:
+    TruePeakLimiter() = default;
+
+    void prepare(int numChannels, double sampleRate, int maxBlockSize);
+    void release(); // Frees everything; getLatencySamples() is 0 until the next prepare()
+    void reset();
+
+    void setCeilingDecibels(float ceilingDb); // dBTP; LIMITER_CEILING_DB until set. Any thread that processes, cheap when unchanged
+
+    [[nodiscard]] bool isPrepared() const { return numChannels_ > 0; }
+    [[nodiscard]] int getLatencySamples() const { return latencySamples_; }
+
+    // In place on [startSample, startSample + numSamples): input gain per sample from
+    // inputGainRamp, or inputGain if that is nullptr
+    void process(juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples,
+                 const float* inputGainRamp, float inputGain);
+
+private:
+    static constexpr int OVERSAMPLING = 4;
+    static constexpr int INTERPOLATOR_TAPS = 16; // Per phase
+    static constexpr int DETECTOR_DELAY = INTERPOLATOR_TAPS / 2; // Newest input to the interpolated span
+
+    void computeGains(int numSamples); // peaks_ -> gains_
+
+    // Phases 1..3 (phase 0 is the sample itself)
+    std::array<std::array<SampleType, INTERPOLATOR_TAPS>, OVERSAMPLING - 1> phaseCoefficients_ {};
+
+    std::vector<SampleType> history_; // Per channel, doubled ring of 2 x INTERPOLATOR_TAPS
+    int historyPosition_ = 0;
+
+    std::vector<SampleType> delay_; // Per channel, ring of delayCapacity_ (power of two)
+    int delayCapacity_ = 0;
+    int delayWritePosition_ = 0;
+
+    std::vector<float> peaks_;      // Per block: largest true peak per sample, all channels
+    std::vector<SampleType> gains_; // Per block: limiting gain for the delayed output
+
+    // Gain computer: sliding minimum (monotonic queue), release, moving average
+    std::vector<float> holdValues_;
+    std::vector<juce::int64> holdTimes_;
+    int holdHead_ = 0;
+    int holdSize_ = 0;
+    juce::int64 sampleTime_ = 0;
+
+    std::vector<float> averageHistory_;
+    double averageSum_ = 0.0;
+    int averagePosition_ = 0;
+
+    float envelope_ = 1.0f;
+    float releaseCoefficient_ = 0.0f;
+    float ceilingDb_ = ultraglitch::config::LIMITER_CEILING_DB;
+    float ceiling_ = 1.0f; // ceilingDb_ as a gain
+
+    int numChannels_ = 0;
+    int maxBlockSize_ = 0;
+    int lookaheadSamples_ = 0;
+    int latencySamples_ = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TruePeakLimiter)
+};
+} // namespace ultraglitch::dsp
@@ -50,17 +50,10 @@ void EffectModule::createUiComponents()
 
     for (size_t i = 1; i < parameterIDs_.size(); ++i)
     {
-        auto paramDef = PluginParameters::get_parameter_definitions();
         juce::String paramName;
 
-        for (const auto& def : paramDef)
-        {
-            if (def.id == parameterIDs_[i])
-            {
-                paramName = def.name;
-                break;
-            }
-        }
+        if (const auto* spec = ultraglitch::params::find_parameter_spec(parameterIDs_[i].toRawUTF8()))
+            paramName = ultraglitch::params::to_juce_string(spec->name);
 
         if (paramName.isEmpty())
             paramName = "Param " + juce::String(i);
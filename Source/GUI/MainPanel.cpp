@@ -112,7 +112,42 @@ void MainPanel::createEffectModules()
         std::vector<juce::String>{
             ultraglitch::params::Global_ChaosMode,
             ultraglitch::params::ChaosController_Speed,
-            ultraglitch::params::ChaosController_Intensity
+            ultraglitch::params::ChaosController_Intensity,
+            ultraglitch::params::ChaosController_Slew,
+            ultraglitch::params::ChaosController_HostSync,
+            ultraglitch::params::ChaosController_Reorder
+        }));
+
+    effectModules_.push_back(std::make_unique<EffectModule>(
+        "Mod 1", pluginParameters_,
+        std::vector<juce::String>{
+            ultraglitch::params::Modulation1_Enabled,
+            ultraglitch::params::Modulation1_Source,
+            ultraglitch::params::Modulation1_Target,
+            ultraglitch::params::Modulation1_Depth
+        }));
+
+    effectModules_.push_back(std::make_unique<EffectModule>(
+        "Mod 2", pluginParameters_,
+        std::vector<juce::String>{
+            ultraglitch::params::Modulation2_Enabled,
+            ultraglitch::params::Modulation2_Source,
+            ultraglitch::params::Modulation2_Target,
+            ultraglitch::params::Modulation2_Depth
+        }));
+
+    effectModules_.push_back(std::make_unique<EffectModule>(
+        "Engine", pluginParameters_,
+        std::vector<juce::String>{
+            ultraglitch::params::Engine_InternalRate,
+            ultraglitch::params::Engine_Oversampling
+        }));
+
+    effectModules_.push_back(std::make_unique<EffectModule>(
+        "Limiter", pluginParameters_,
+        std::vector<juce::String>{
+            ultraglitch::params::Limiter_Enabled,
+            ultraglitch::params::Limiter_Ceiling
         }));
 
     for (auto& module : effectModules_)
@@ -149,7 +184,7 @@ void MainPanel::layoutComponents()
     int currentY = modulesBounds.getY();
     const int moduleSpacingX = padding_;
     const int moduleSpacingY = padding_;
-    const int modulesPerRow = 3;
+    const int modulesPerRow = 4;
 
     moduleWidth_ =
         (modulesBounds.getWidth() - (modulesPerRow - 1) * moduleSpacingX)
@@ -39,7 +39,7 @@ private:
     int moduleWidth_ = 150;
     int moduleHeight_ = 200;
     static constexpr int padding_ = 10;
-    static constexpr int numEffectModules_ = 7;
+    static constexpr int numEffectModules_ = 11;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainPanel)
 };
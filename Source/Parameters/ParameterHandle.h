@@ -0,0 +1,38 @@
+#ifndef PARAMETERHANDLE_H
+#define PARAMETERHANDLE_H
+
+#include <atomic>
+#include "../Common/ParameterIDs.h"
+
+/**
+    Cached, lock-free view of a single APVTS parameter value.
+
+    Resolved once (by string) when an effect is constructed; afterwards reading
+    the parameter on the audio thread is a single relaxed atomic load.
+    An unbound handle (no PluginParameters available) simply reports !isBound().
+*/
+class ParameterHandle
+{
+public:
+    ParameterHandle() = default;
+
+    ParameterHandle(ultraglitch::params::ParamIndex index, std::atomic<float>* value)
+        : index_(index), value_(value)
+    {
+    }
+
+    [[nodiscard]] bool isBound() const { return value_ != nullptr; }
+    [[nodiscard]] ultraglitch::params::ParamIndex getIndex() const { return index_; }
+
+    /** Returns the current real (denormalized) value, or fallback when unbound. */
+    [[nodiscard]] float load(float fallback = 0.0f) const
+    {
+        return value_ != nullptr ? value_->load(std::memory_order_relaxed) : fallback;
+    }
+
+private:
+    ultraglitch::params::ParamIndex index_ = ultraglitch::params::ParamIndex::Count;
+    std::atomic<float>* value_ = nullptr;
+};
+
+#endif // PARAMETERHANDLE_H
@@ -0,0 +1,296 @@
+#ifndef PARAMETERREGISTRY_H
+#define PARAMETERREGISTRY_H
+
+#include <array>
+#include <string_view>
+#include <juce_core/juce_core.h>
+#include "../Common/ParameterIDs.h"
+
+namespace ultraglitch::params
+{
+    enum class ParameterType
+    {
+        Float,
+        Bool,
+        Choice
+    };
+
+    // One plugin parameter, fully described at compile time. Strings are views of
+    // literals (null-terminated), so building the table costs nothing at load.
+    struct ParameterSpec
+    {
+        ParamIndex index;
+        std::string_view id;
+        std::string_view name;
+        std::string_view label;
+        ParameterType type;
+        float minValue;
+        float maxValue;
+        float stepValue;
+        float skewFactor;
+        float defaultValue;
+        std::string_view choices; // '|'-separated, Choice parameters only
+        bool automatable = true; // False for settings hosts shouldn't automate (structure, latency)
+    };
+
+    // Modulation slot choices. A target choice n > 0 is MODULATION_TARGETS[n - 1], and its
+    // text is that parameter's name
+    inline constexpr std::string_view MODULATION_SOURCE_CHOICES = "Sine LFO|Triangle LFO|Sample & Hold|Random|Envelope";
+
+    inline constexpr std::array<ParamIndex, 22> MODULATION_TARGETS = {{
+        ParamIndex::Global_Gain,
+        ParamIndex::BitCrusher_BitDepth, ParamIndex::BitCrusher_SampleRateDiv, ParamIndex::BitCrusher_Mix,
+        ParamIndex::BufferStutter_Rate, ParamIndex::BufferStutter_Length, ParamIndex::BufferStutter_Mix,
+        ParamIndex::PitchDrift_Amount, ParamIndex::PitchDrift_Speed, ParamIndex::PitchDrift_Mix,
+        ParamIndex::ReverseSlice_Interval, ParamIndex::ReverseSlice_Chance, ParamIndex::ReverseSlice_Mix,
+        ParamIndex::SliceRearrange_SliceCount, ParamIndex::SliceRearrange_Randomize, ParamIndex::SliceRearrange_Mix,
+        ParamIndex::WeirdFlanger_Rate, ParamIndex::WeirdFlanger_Depth, ParamIndex::WeirdFlanger_Feedback, ParamIndex::WeirdFlanger_Mix,
+        ParamIndex::ChaosController_Speed, ParamIndex::ChaosController_Intensity,
+    }};
+
+    inline constexpr std::string_view MODULATION_TARGET_CHOICES =
+        "None|Output Gain|Bit Depth|Sample Rate Divisor|Bitcrusher Mix|Stutter Rate|Stutter Length|Stutter Mix"
+        "|Drift Amount|Drift Speed|Pitch Drift Mix|Slice Interval|Reverse Chance|Reverse Slice Mix"
+        "|Slice Count|Randomize Amount|Rearrange Mix|Flanger Rate|Flanger Depth|Flanger Feedback|Flanger Mix"
+        "|Chaos Speed|Chaos Intensity";
+
+    // Ordered by ParamIndex: PARAMETER_REGISTRY[to_int(index)].index == index
+    inline constexpr std::array<ParameterSpec, NUM_PARAMETERS> PARAMETER_REGISTRY = {{
+        // Global parameters
+        { ParamIndex::Global_Gain, Global_Gain, "Output Gain", "",
+          ParameterType::Float, 0.0f, 2.0f, 0.01f, 1.0f, 1.0f, {} }, // Range 0.0-2.0, default 1.0 (linear)
+        { ParamIndex::Global_ChaosMode, Global_ChaosMode, "Chaos Mode", "",
+          ParameterType::Bool, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, {} },
+
+        // Bit Crusher parameters
+        { ParamIndex::BitCrusher_Enabled, BitCrusher_Enabled, "Bitcrusher Enabled", "",
+          ParameterType::Bool, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, {} },
+        { ParamIndex::BitCrusher_BitDepth, BitCrusher_BitDepth, "Bit Depth", "bits",
+          ParameterType::Float, 1.0f, 16.0f, 1.0f, 1.0f, 16.0f, {} },
+        { ParamIndex::BitCrusher_SampleRateDiv, BitCrusher_SampleRateDiv, "Sample Rate Divisor", "",
+          ParameterType::Float, 1.0f, 64.0f, 1.0f, 1.0f, 1.0f, {} },
+        { ParamIndex::BitCrusher_Mix, BitCrusher_Mix, "Bitcrusher Mix", "",
+          ParameterType::Float, 0.0f, 1.0f, 0.01f, 1.0f, 0.0f, {} },
+
+        // Buffer Stutter parameters
+        { ParamIndex::BufferStutter_Enabled, BufferStutter_Enabled, "Stutter Enabled", "",
+          ParameterType::Bool, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, {} },
+        { ParamIndex::BufferStutter_Rate, BufferStutter_Rate, "Stutter Rate", "Divisions",
+          ParameterType::Float, 1.0f, 16.0f, 1.0f, 1.0f, 4.0f, {} },
+        { ParamIndex::BufferStutter_Length, BufferStutter_Length, "Stutter Length", "ms",
+          ParameterType::Float, 10.0f, 500.0f, 1.0f, 0.5f, 100.0f, {} },
+        { ParamIndex::BufferStutter_Mix, BufferStutter_Mix, "Stutter Mix", "",
+          ParameterType::Float, 0.0f, 1.0f, 0.01f, 1.0f, 0.0f, {} },
+
+        // Pitch Drift parameters
+        { ParamIndex::PitchDrift_Enabled, PitchDrift_Enabled, "Pitch Drift Enabled", "",
+          ParameterType::Bool, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, {} },
+        { ParamIndex::PitchDrift_Amount, PitchDrift_Amount, "Drift Amount", "cents",
+          ParameterType::Float, 0.0f, 1200.0f, 1.0f, 1.0f, 0.0f, {} }, // 0-1200 cents (1 octave)
+        { ParamIndex::PitchDrift_Speed, PitchDrift_Speed, "Drift Speed", "Hz",
+          ParameterType::Float, 0.01f, 10.0f, 0.01f, 0.5f, 1.0f, {} },
+        { ParamIndex::PitchDrift_Mix, PitchDrift_Mix, "Pitch Drift Mix", "",
+          ParameterType::Float, 0.0f, 1.0f, 0.01f, 1.0f, 0.0f, {} },
+
+        // Reverse Slice parameters
+        { ParamIndex::ReverseSlice_Enabled, ReverseSlice_Enabled, "Reverse Slice Enabled", "",
+          ParameterType::Bool, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, {} },
+        { ParamIndex::ReverseSlice_Interval, ReverseSlice_Interval, "Slice Interval", "ms",
+          ParameterType::Float, 50.0f, 1000.0f, 10.0f, 0.5f, 200.0f, {} },
+        { ParamIndex::ReverseSlice_Chance, ReverseSlice_Chance, "Reverse Chance", "",
+          ParameterType::Float, 0.0f, 1.0f, 0.01f, 1.0f, 0.5f, {} },
+        { ParamIndex::ReverseSlice_Mix, ReverseSlice_Mix, "Reverse Slice Mix", "",
+          ParameterType::Float, 0.0f, 1.0f, 0.01f, 1.0f, 0.0f, {} },
+
+        // Slice Rearrange parameters
+        { ParamIndex::SliceRearrange_Enabled, SliceRearrange_Enabled, "Rearrange Enabled", "",
+          ParameterType::Bool, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, {} },
+        { ParamIndex::SliceRearrange_SliceCount, SliceRearrange_SliceCount, "Slice Count", "slices",
+          ParameterType::Float, 2.0f, 16.0f, 1.0f, 1.0f, 4.0f, {} },
+        { ParamIndex::SliceRearrange_Randomize, SliceRearrange_Randomize, "Randomize Amount", "",
+          ParameterType::Float, 0.0f, 1.0f, 0.01f, 1.0f, 0.0f, {} },
+        { ParamIndex::SliceRearrange_Mix, SliceRearrange_Mix, "Rearrange Mix", "",
+          ParameterType::Float, 0.0f, 1.0f, 0.01f, 1.0f, 0.0f, {} },
+
+        // Weird Flanger parameters
+        { ParamIndex::WeirdFlanger_Enabled, WeirdFlanger_Enabled, "Flanger Enabled", "",
+          ParameterType::Bool, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, {} },
+        { ParamIndex::WeirdFlanger_Rate, WeirdFlanger_Rate, "Flanger Rate", "Hz",
+          ParameterType::Float, 0.01f, 20.0f, 0.01f, 0.5f, 1.0f, {} },
+        { ParamIndex::WeirdFlanger_Depth, WeirdFlanger_Depth, "Flanger Depth", "",
+          ParameterType::Float, 0.0f, 1.0f, 0.01f, 1.0f, 0.8f, {} },
+        { ParamIndex::WeirdFlanger_Feedback, WeirdFlanger_Feedback, "Flanger Feedback", "",
+          ParameterType::Float, -1.0f, 1.0f, 0.01f, 1.0f, 0.0f, {} },
+        { ParamIndex::WeirdFlanger_Mix, WeirdFlanger_Mix, "Flanger Mix", "",
+          ParameterType::Float, 0.0f, 1.0f, 0.01f, 1.0f, 0.0f, {} },
+
+        // Chaos Controller parameters (enabled via Global_ChaosMode)
+        { ParamIndex::ChaosController_Speed, ChaosController_Speed, "Chaos Speed", "Hz",
+          ParameterType::Float, 0.01f, 10.0f, 0.01f, 0.5f, 4.0f, {} },
+        { ParamIndex::ChaosController_Intensity, ChaosController_Intensity, "Chaos Intensity", "%",
+          ParameterType::Float, 0.0f, 100.0f, 1.0f, 1.0f, 100.0f, {} },
+        { ParamIndex::ChaosController_Slew, ChaosController_Slew, "Chaos Slew", "ms",
+          ParameterType::Float, 0.0f, 2000.0f, 1.0f, 0.5f, 0.0f, {} }, // 0 = jump (pre-morph behaviour)
+        { ParamIndex::ChaosController_HostSync, ChaosController_HostSync, "Chaos Host Sync", "",
+          ParameterType::Bool, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, {} }, // Off = internal modulation, no host updates
+        { ParamIndex::ChaosController_Reorder, ChaosController_Reorder, "Chaos Reorder", "",
+          ParameterType::Bool, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, {} },
+
+        // Modulation route slots. Source choices follow dsp::ModulationSource; Target choices
+        // are "None" then MODULATION_TARGETS (both static_asserted)
+        { ParamIndex::Modulation1_Enabled, Modulation1_Enabled, "Mod 1 Enabled", "",
+          ParameterType::Bool, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, {}, false },
+        { ParamIndex::Modulation1_Source, Modulation1_Source, "Mod 1 Source", "",
+          ParameterType::Choice, 0.0f, 4.0f, 1.0f, 1.0f, 0.0f, MODULATION_SOURCE_CHOICES, false },
+        { ParamIndex::Modulation1_Target, Modulation1_Target, "Mod 1 Target", "",
+          ParameterType::Choice, 0.0f, 22.0f, 1.0f, 1.0f, 0.0f, MODULATION_TARGET_CHOICES, false },
+        { ParamIndex::Modulation1_Depth, Modulation1_Depth, "Mod 1 Depth", "",
+          ParameterType::Float, -1.0f, 1.0f, 0.01f, 1.0f, 0.0f, {}, false },
+        { ParamIndex::Modulation2_Enabled, Modulation2_Enabled, "Mod 2 Enabled", "",
+          ParameterType::Bool, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, {}, false },
+        { ParamIndex::Modulation2_Source, Modulation2_Source, "Mod 2 Source", "",
+          ParameterType::Choice, 0.0f, 4.0f, 1.0f, 1.0f, 0.0f, MODULATION_SOURCE_CHOICES, false },
+        { ParamIndex::Modulation2_Target, Modulation2_Target, "Mod 2 Target", "",
+          ParameterType::Choice, 0.0f, 22.0f, 1.0f, 1.0f, 0.0f, MODULATION_TARGET_CHOICES, false },
+        { ParamIndex::Modulation2_Depth, Modulation2_Depth, "Mod 2 Depth", "",
+          ParameterType::Float, -1.0f, 1.0f, 0.01f, 1.0f, 0.0f, {}, false },
+
+        // Engine settings: the processor re-prepares when one changes, and reports the new latency
+        { ParamIndex::Engine_InternalRate, Engine_InternalRate, "Internal Rate", "",
+          ParameterType::Bool, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, {}, false }, // Adds 126/282/594 host samples at 2x/4x/8x
+        { ParamIndex::Engine_Oversampling, Engine_Oversampling, "Oversampling", "",
+          ParameterType::Choice, 0.0f, 3.0f, 1.0f, 1.0f, 1.0f, "1x|2x|4x|8x", false }, // Choice n = factor 2^n
+
+        // Output limiter
+        { ParamIndex::Limiter_Enabled, Limiter_Enabled, "Limiter Enabled", "",
+          ParameterType::Bool, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, {}, false }, // Engine setting: adds ~1.5 ms of lookahead
+        { ParamIndex::Limiter_Ceiling, Limiter_Ceiling, "Limiter Ceiling", "dBTP",
+          ParameterType::Float, -12.0f, 0.0f, 0.1f, 1.0f, -1.0f, {} }, // Default = config::LIMITER_CEILING_DB
+    }};
+
+    // Parameters of one modulation route slot; slot i drives ModulationMatrix route i
+    struct ModulationSlotParameters
+    {
+        ParamIndex enabled;
+        ParamIndex source;
+        ParamIndex target;
+        ParamIndex depth;
+    };
+
+    inline constexpr std::array<ModulationSlotParameters, 2> MODULATION_SLOT_PARAMETERS = {{
+        { ParamIndex::Modulation1_Enabled, ParamIndex::Modulation1_Source, ParamIndex::Modulation1_Target, ParamIndex::Modulation1_Depth },
+        { ParamIndex::Modulation2_Enabled, ParamIndex::Modulation2_Source, ParamIndex::Modulation2_Target, ParamIndex::Modulation2_Depth },
+    }};
+
+    constexpr const ParameterSpec& get_parameter_spec(ParamIndex index)
+    {
+        return PARAMETER_REGISTRY[static_cast<size_t>(index)];
+    }
+
+    // Linear search by ID; nullptr if unknown. Meant for UI/setup code, not the audio thread.
+    constexpr const ParameterSpec* find_parameter_spec(std::string_view id)
+    {
+        for (const auto& spec : PARAMETER_REGISTRY)
+            if (spec.id == id)
+                return &spec;
+
+        return nullptr;
+    }
+
+    constexpr int count_choices(std::string_view choices)
+    {
+        if (choices.empty())
+            return 0;
+
+        int count = 1;
+        for (char c : choices)
+            if (c == '|')
+                ++count;
+
+        return count;
+    }
+
+    // Registry strings (IDs, names, labels, choices) for JUCE APIs; setup/UI threads only
+    inline juce::String to_juce_string(std::string_view text)
+    {
+        return juce::String::fromUTF8(text.data(), static_cast<int>(text.size()));
+    }
+
+    namespace detail
+    {
+        constexpr bool registry_is_in_index_order()
+        {
+            for (int i = 0; i < NUM_PARAMETERS; ++i)
+                if (to_int(PARAMETER_REGISTRY[static_cast<size_t>(i)].index) != i)
+                    return false;
+
+            return true;
+        }
+
+        constexpr bool registry_ids_are_unique()
+        {
+            for (size_t i = 0; i < PARAMETER_REGISTRY.size(); ++i)
+            {
+                if (PARAMETER_REGISTRY[i].id.empty())
+                    return false;
+
+                for (size_t j = i + 1; j < PARAMETER_REGISTRY.size(); ++j)
+                    if (PARAMETER_REGISTRY[i].id == PARAMETER_REGISTRY[j].id)
+                        return false;
+            }
+
+            return true;
+        }
+
+        constexpr bool registry_ranges_are_valid()
+        {
+            for (const auto& spec : PARAMETER_REGISTRY)
+            {
+                if (!(spec.minValue < spec.maxValue) || spec.stepValue < 0.0f || !(spec.skewFactor > 0.0f))
+                    return false;
+
+                if (spec.defaultValue < spec.minValue || spec.defaultValue > spec.maxValue)
+                    return false;
+
+                const bool hasChoices = !spec.choices.empty();
+                if (hasChoices != (spec.type == ParameterType::Choice))
+                    return false;
+
+                if (spec.type == ParameterType::Choice
+                    && (static_cast<int>(spec.defaultValue) >= count_choices(spec.choices)
+                        || spec.minValue != 0.0f || static_cast<int>(spec.maxValue) != count_choices(spec.choices) - 1))
+                    return false;
+            }
+
+            return true;
+        }
+
+        constexpr bool modulation_target_choices_match()
+        {
+            std::string_view remaining = MODULATION_TARGET_CHOICES;
+            const auto none = remaining.find('|');
+            if (remaining.substr(0, none) != "None")
+                return false;
+
+            remaining.remove_prefix(none + 1);
+
+            for (size_t i = 0; i < MODULATION_TARGETS.size(); ++i)
+            {
+                const auto end = remaining.find('|');
+                if (remaining.substr(0, end) != get_parameter_spec(MODULATION_TARGETS[i]).name)
+                    return false;
+
+                remaining = end == std::string_view::npos ? std::string_view{} : remaining.substr(end + 1);
+            }
+
+            return remaining.empty();
+        }
+    }
+
+    static_assert(detail::registry_is_in_index_order(), "PARAMETER_REGISTRY must be ordered by ParamIndex");
+    static_assert(detail::registry_ids_are_unique(), "Parameter IDs must be unique and non-empty");
+    static_assert(detail::registry_ranges_are_valid(), "Parameter ranges, defaults or choices are invalid");
+    static_assert(detail::modulation_target_choices_match(), "MODULATION_TARGET_CHOICES must be \"None\" then the MODULATION_TARGETS names");
+}
+
+#endif // PARAMETERREGISTRY_H
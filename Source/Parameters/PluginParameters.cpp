@@ -6,11 +6,28 @@
 PluginParameters::PluginParameters(juce::AudioProcessor& processor)
     : apvts_(processor, nullptr, "PARAMETERS", create_parameter_layout())
 {
+    // APVTS listeners fire after the raw atomic value is updated, so a dirty bit
+    // never becomes visible before the value it refers to
+    const auto& definitions = get_parameter_definitions();
+    for (size_t i = 0; i < dirty_flag_listeners_.size(); ++i)
+    {
+        const auto param_id = ultraglitch::params::to_juce_string(definitions[i].id);
+        parameters_[i] = apvts_.getParameter(param_id);
+
+        dirty_flag_listeners_[i].owner = this;
+        dirty_flag_listeners_[i].index = static_cast<ultraglitch::params::ParamIndex>(i);
+        apvts_.addParameterListener(param_id, &dirty_flag_listeners_[i]);
+    }
+
     initialize_parameter_attachments();
 }
 
 PluginParameters::~PluginParameters()
 {
+    const auto& definitions = get_parameter_definitions();
+    for (size_t i = 0; i < dirty_flag_listeners_.size(); ++i)
+        apvts_.removeParameterListener(ultraglitch::params::to_juce_string(definitions[i].id), &dirty_flag_listeners_[i]);
+
     // Clean up attachments
     for (auto& attachment : parameter_attachments_)
     {
@@ -21,9 +38,12 @@ PluginParameters::~PluginParameters()
 
 juce::AudioProcessorValueTreeState::ParameterLayout PluginParameters::create_parameter_layout()
 {
+    using ultraglitch::params::ParameterType;
+    using ultraglitch::params::to_juce_string;
+
     juce::AudioProcessorValueTreeState::ParameterLayout layout;
     
-    // Add all parameters from the definitions
+    // Generated from the compile-time registry, in ParamIndex order
     for (const auto& param_def : get_parameter_definitions())
     {
         switch (param_def.type)
@@ -38,12 +58,13 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginParameters::create_par
                 );
                 
                 layout.add(std::make_unique<juce::AudioParameterFloat>(
-                    juce::ParameterID(param_def.id, 1),
-                    param_def.name,
+                    juce::ParameterID(to_juce_string(param_def.id), 1),
+                    to_juce_string(param_def.name),
                     range,
                     param_def.defaultValue,
                     juce::AudioParameterFloatAttributes()
-                        .withLabel(param_def.label)
+                        .withLabel(to_juce_string(param_def.label))
+                        .withAutomatable(param_def.automatable)
                 ));
                 break;
             }
@@ -51,30 +72,28 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginParameters::create_par
             case ParameterType::Bool:
             {
                 layout.add(std::make_unique<juce::AudioParameterBool>(
-                    juce::ParameterID(param_def.id, 1),
-                    param_def.name,
+                    juce::ParameterID(to_juce_string(param_def.id), 1),
+                    to_juce_string(param_def.name),
                     static_cast<bool>(param_def.defaultValue),
                     juce::AudioParameterBoolAttributes()
-                        .withLabel(param_def.label)
+                        .withLabel(to_juce_string(param_def.label))
+                        .withAutomatable(param_def.automatable)
                 ));
                 break;
             }
             
             case ParameterType::Choice:
             {
-                juce::StringArray choices;
-                for (const auto& choice : param_def.choices)
-                {
-                    choices.add(choice);
-                }
+                auto choices = juce::StringArray::fromTokens(to_juce_string(param_def.choices), "|", "");
                 
                 layout.add(std::make_unique<juce::AudioParameterChoice>(
-                    juce::ParameterID(param_def.id, 1),
-                    param_def.name,
+                    juce::ParameterID(to_juce_string(param_def.id), 1),
+                    to_juce_string(param_def.name),
                     choices,
                     static_cast<int>(param_def.defaultValue),
                     juce::AudioParameterChoiceAttributes()
-                        .withLabel(param_def.label)
+                        .withLabel(to_juce_string(param_def.label))
+                        .withAutomatable(param_def.automatable)
                 ));
                 break;
             }
@@ -89,13 +108,14 @@ void PluginParameters::initialize_parameter_attachments()
     // Create attachments for all parameters
     for (const auto& param_def : get_parameter_definitions())
     {
-        auto* parameter = apvts_.getParameter(param_def.id);
+        const auto param_id = ultraglitch::params::to_juce_string(param_def.id);
+        auto* parameter = apvts_.getParameter(param_id);
         if (parameter != nullptr)
         {
             // Create a lambda-based attachment for this parameter
             auto attachment = std::make_unique<juce::ParameterAttachment>(
                 *parameter,
-                [this, param_id = param_def.id](float normalizedValue) // normalized_value from APVTS
+                [this, param_id](float normalizedValue) // normalized_value from APVTS
                 {
                     handle_parameter_change(param_id, normalizedValue);
                 },
@@ -117,18 +137,42 @@ float PluginParameters::get_parameter_value(const juce::String& parameter_id) co
     return 0.0f;
 }
 
+std::atomic<float>* PluginParameters::get_raw_parameter_value(ultraglitch::params::ParamIndex index) const
+{
+    const auto& definitions = get_parameter_definitions();
+    const auto i = static_cast<size_t>(index);
+
+    if (i < definitions.size())
+        return apvts_.getRawParameterValue(ultraglitch::params::to_juce_string(definitions[i].id));
+
+    return nullptr;
+}
+
+ParameterHandle PluginParameters::get_parameter_handle(ultraglitch::params::ParamIndex index) const
+{
+    return ParameterHandle(index, get_raw_parameter_value(index));
+}
+
 void PluginParameters::set_parameter_value(const juce::String& parameter_id, float new_real_value)
 {
     if (auto* parameter = apvts_.getParameter(parameter_id))
     {
         // Convert real value to normalized 0-1 before setting
-        if (auto* rp = dynamic_cast<juce::RangedAudioParameter*>(parameter))
-        {
-            rp->setValueNotifyingHost(rp->convertTo0to1(new_real_value));
-        }
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(new_real_value));
     }
 }
 
+void PluginParameters::set_parameter_value(ultraglitch::params::ParamIndex index, float new_real_value)
+{
+    if (auto* parameter = get_parameter(index))
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(new_real_value));
+}
+
+void PluginParameters::set_parameter_values(const ParameterBatch& batch)
+{
+    apply_batch(batch, false);
+}
+
 juce::String PluginParameters::get_parameter_text(const juce::String& parameter_id) const
 {
     auto* parameter = apvts_.getParameter(parameter_id);
@@ -145,6 +189,12 @@ juce::RangedAudioParameter* PluginParameters::get_parameter(const juce::String&
     return apvts_.getParameter(parameter_id);
 }
 
+juce::RangedAudioParameter* PluginParameters::get_parameter(ultraglitch::params::ParamIndex index) const
+{
+    const auto i = static_cast<size_t>(index);
+    return i < parameters_.size() ? parameters_[i] : nullptr;
+}
+
 juce::AudioProcessorValueTreeState& PluginParameters::get_value_tree_state()
 {
     return apvts_;
@@ -160,7 +210,7 @@ void PluginParameters::add_listener(juce::AudioProcessorValueTreeState::Listener
     // Register for all defined parameters
     for (const auto& param_def : get_parameter_definitions())
     {
-        apvts_.addParameterListener(param_def.id, listener);
+        apvts_.addParameterListener(ultraglitch::params::to_juce_string(param_def.id), listener);
     }
 }
 
@@ -169,12 +219,16 @@ void PluginParameters::remove_listener(juce::AudioProcessorValueTreeState::Liste
     // Unregister from all defined parameters
     for (const auto& param_def : get_parameter_definitions())
     {
-        apvts_.removeParameterListener(param_def.id, listener);
+        apvts_.removeParameterListener(ultraglitch::params::to_juce_string(param_def.id), listener);
     }
 }
 
 void PluginParameters::handle_parameter_change(const juce::String& parameter_id, float new_value)
 {
+    // Inside a batch the attachments fire synchronously; apply_batch() notifies once at the end
+    if (batch_in_progress_)
+        return;
+
     // Note: ParameterAttachment callback provides the denormalized (real) value
     parameter_listeners_.call([&](ParameterListener& listener)
     {
@@ -182,6 +236,89 @@ void PluginParameters::handle_parameter_change(const juce::String& parameter_id,
     });
 }
 
+void PluginParameters::DirtyFlagListener::parameterChanged(const juce::String& parameterID, float newValue)
+{
+    juce::ignoreUnused(parameterID, newValue); // Value is read later through the ParameterHandle
+
+    // APVTS calls listeners synchronously on the changing thread, so on the message thread
+    // a set bit means this is our own publish echo; host automation from other threads
+    // always marks the parameter dirty
+    if ((owner->publishing_mask_.load(std::memory_order_relaxed) & ultraglitch::params::to_mask(index)) != 0
+        && juce::MessageManager::existsAndIsCurrentThread())
+        return;
+
+    owner->mark_parameter_dirty(index);
+}
+
+void PluginParameters::publish_parameter_values(const ParameterBatch& batch)
+{
+    apply_batch(batch, true);
+}
+
+void PluginParameters::publish_parameter_value(ultraglitch::params::ParamIndex index, float new_real_value)
+{
+    ParameterBatch batch;
+    batch.set(index, new_real_value);
+    apply_batch(batch, true);
+}
+
+void PluginParameters::apply_batch(const ParameterBatch& batch, bool publishing)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    if (batch.is_empty())
+        return;
+
+    if (publishing)
+        publishing_mask_.store(batch.mask, std::memory_order_relaxed);
+
+    batch_in_progress_ = true;
+
+    // Open every gesture before the first change and close them after the last, so
+    // hosts record the batch as one overlapping edit
+    for (auto bits = batch.mask; bits != 0; bits &= bits - 1)
+        if (auto* parameter = get_parameter(ultraglitch::params::lowest_set_index(bits)))
+            parameter->beginChangeGesture();
+
+    for (auto bits = batch.mask; bits != 0; bits &= bits - 1)
+    {
+        const auto index = ultraglitch::params::lowest_set_index(bits);
+        if (auto* parameter = get_parameter(index))
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(batch.values[static_cast<size_t>(index)]));
+    }
+
+    for (auto bits = batch.mask; bits != 0; bits &= bits - 1)
+        if (auto* parameter = get_parameter(ultraglitch::params::lowest_set_index(bits)))
+            parameter->endChangeGesture();
+
+    batch_in_progress_ = false;
+    publishing_mask_.store(0, std::memory_order_relaxed);
+
+    parameter_listeners_.call([&](ParameterListener& listener)
+    {
+        listener.parameters_changed(batch.mask, batch.values);
+    });
+}
+
+void PluginParameters::mark_parameter_dirty(ultraglitch::params::ParamIndex index)
+{
+    dirty_parameters_.fetch_or(ultraglitch::params::to_mask(index), std::memory_order_release);
+}
+
+void PluginParameters::mark_all_parameters_dirty()
+{
+    dirty_parameters_.store(ultraglitch::params::ALL_PARAMETERS_MASK, std::memory_order_release);
+}
+
+ultraglitch::params::ParamMask PluginParameters::consume_dirty_parameters()
+{
+    // Cheap early-out for the common "nothing moved" block
+    if (dirty_parameters_.load(std::memory_order_relaxed) == 0)
+        return 0;
+
+    return dirty_parameters_.exchange(0, std::memory_order_acquire);
+}
+
 void PluginParameters::add_parameter_listener(ParameterListener* listener)
 {
     parameter_listeners_.add(listener);
@@ -221,263 +358,11 @@ bool PluginParameters::load_state_from_xml(const juce::XmlElement& xml)
 
 void PluginParameters::reset_to_defaults()
 {
+    ParameterBatch batch;
     for (const auto& param_def : get_parameter_definitions())
     {
-        set_parameter_value(param_def.id, param_def.defaultValue); // defaultValue is real value
+        batch.set(param_def.index, param_def.defaultValue); // defaultValue is real value
     }
-}
 
-const std::vector<ParameterDefinition>& PluginParameters::get_parameter_definitions()
-{
-    static const std::vector<ParameterDefinition> definitions = {
-        // Global parameters
-        {
-            ultraglitch::params::Global_OutputGain, // ID from tasq.md
-            "Output Gain",
-            "", // No label in tasq.md
-            ParameterType::Float,
-            0.0f, 2.0f, 0.01f, 1.0f, 1.0f, // Range 0.0-2.0, default 1.0 (linear)
-            {}
-        },
-        {
-            ultraglitch::params::Global_ChaosMode, // ID from tasq.md
-            "Chaos Mode",
-            "", // No label in tasq.md
-            ParameterType::Bool,
-            0.0f, 1.0f, 1.0f, 1.0f, 0.0f, // false by default
-            {}
-        },
-        
-        // Bit Crusher parameters
-        {
-            ultraglitch::params::BitCrusher_Enabled, // ID from tasq.md
-            "Bitcrusher Enabled",
-            "", // No label in tasq.md
-            ParameterType::Bool,
-            0.0f, 1.0f, 1.0f, 1.0f, 0.0f, // false by default
-            {}
-        },
-        {
-            ultraglitch::params::BitCrusher_BitDepth, // ID from tasq.md
-            "Bit Depth",
-            "bits",
-            ParameterType::Float,
-            1.0f, 16.0f, 1.0f, 1.0f, 16.0f, // Range 1-16, default 16
-            {}
-        },
-        {
-            ultraglitch::params::BitCrusher_SampleRateDiv, // ID from tasq.md
-            "Sample Rate Divisor",
-            "", // No label in tasq.md
-            ParameterType::Float,
-            1.0f, 64.0f, 1.0f, 1.0f, 1.0f, // Range 1-64, default 1
-            {}
-        },
-        {
-            ultraglitch::params::BitCrusher_Mix, // ID from tasq.md
-            "Bitcrusher Mix",
-            "", // No label in tasq.md
-            ParameterType::Float,
-            0.0f, 1.0f, 0.01f, 1.0f, 0.0f, // Range 0-1, default 0
-            {}
-        },
-        
-        // Buffer Stutter parameters
-        {
-            ultraglitch::params::BufferStutter_Enabled, // ID from tasq.md
-            "Stutter Enabled",
-            "", // No label in tasq.md
-            ParameterType::Bool,
-            0.0f, 1.0f, 1.0f, 1.0f, 0.0f, // false by default
-            {}
-        },
-        {
-            ultraglitch::params::BufferStutter_Rate, // ID from tasq.md
-            "Stutter Rate",
-            "Divisions",
-            ParameterType::Float,
-            1.0f, 16.0f, 1.0f, 1.0f, 4.0f, // Range 1-16, default 4 divisions
-            {}
-        },
-        {
-            ultraglitch::params::BufferStutter_Length, // ID from tasq.md
-            "Stutter Length",
-            "ms",
-            ParameterType::Float,
-            10.0f, 500.0f, 1.0f, 0.5f, 100.0f, // Range 10-500ms, default 100ms
-            {}
-        },
-        {
-            ultraglitch::params::BufferStutter_Mix, // ID from tasq.md
-            "Stutter Mix",
-            "", // No label in tasq.md
-            ParameterType::Float,
-            0.0f, 1.0f, 0.01f, 1.0f, 0.0f, // Range 0-1, default 0
-            {}
-        },
-        
-        // Pitch Drift parameters
-        {
-            ultraglitch::params::PitchDrift_Enabled, // ID from tasq.md
-            "Pitch Drift Enabled",
-            "", // No label in tasq.md
-            ParameterType::Bool,
-            0.0f, 1.0f, 1.0f, 1.0f, 0.0f, // false by default
-            {}
-        },
-        {
-            ultraglitch::params::PitchDrift_Amount, // ID from tasq.md
-            "Drift Amount",
-            "cents",
-            ParameterType::Float,
-            0.0f, 1200.0f, 1.0f, 1.0f, 0.0f, // Range 0-1200 cents (1 octave), default 0
-            {}
-        },
-        {
-            ultraglitch::params::PitchDrift_Speed, // ID from tasq.md
-            "Drift Speed",
-            "Hz",
-            ParameterType::Float,
-            0.01f, 10.0f, 0.01f, 0.5f, 1.0f, // Range 0.01-10Hz, default 1.0Hz
-            {}
-        },
-        {
-            ultraglitch::params::PitchDrift_Mix, // ID from tasq.md
-            "Pitch Drift Mix",
-            "", // No label in tasq.md
-            ParameterType::Float,
-            0.0f, 1.0f, 0.01f, 1.0f, 0.0f, // Range 0-1, default 0
-            {}
-        },
-        
-        // Reverse Slice parameters
-        {
-            ultraglitch::params::ReverseSlice_Enabled, // ID from tasq.md
-            "Reverse Slice Enabled",
-            "", // No label in tasq.md
-            ParameterType::Bool,
-            0.0f, 1.0f, 1.0f, 1.0f, 0.0f, // false by default
-            {}
-        },
-        {
-            ultraglitch::params::ReverseSlice_Interval, // ID from tasq.md
-            "Slice Interval",
-            "ms",
-            ParameterType::Float,
-            50.0f, 1000.0f, 10.0f, 0.5f, 200.0f, // Range 50-1000ms, default 200ms
-            {}
-        },
-        {
-            ultraglitch::params::ReverseSlice_Chance, // ID from tasq.md
-            "Reverse Chance",
-            "", // No label in tasq.md
-            ParameterType::Float,
-            0.0f, 1.0f, 0.01f, 1.0f, 0.5f, // Range 0-1, default 0.5
-            {}
-        },
-        {
-            ultraglitch::params::ReverseSlice_Mix, // ID from tasq.md
-            "Reverse Slice Mix",
-            "", // No label in tasq.md
-            ParameterType::Float,
-            0.0f, 1.0f, 0.01f, 1.0f, 0.0f, // Range 0-1, default 0
-            {}
-        },
-        
-        // Slice Rearrange parameters
-        {
-            ultraglitch::params::SliceRearrange_Enabled, // ID from tasq.md
-            "Rearrange Enabled",
-            "", // No label in tasq.md
-            ParameterType::Bool,
-            0.0f, 1.0f, 1.0f, 1.0f, 0.0f, // false by default
-            {}
-        },
-        {
-            ultraglitch::params::SliceRearrange_SliceCount, // ID from tasq.md
-            "Slice Count",
-            "slices",
-            ParameterType::Float,
-            2.0f, 16.0f, 1.0f, 1.0f, 4.0f, // Range 2-16, default 4
-            {}
-        },
-        {
-            ultraglitch::params::SliceRearrange_Randomize, // ID from tasq.md
-            "Randomize Amount",
-            "", // No label in tasq.md
-            ParameterType::Float,
-            0.0f, 1.0f, 0.01f, 1.0f, 0.0f, // Range 0-1, default 0
-            {}
-        },
-        {
-            ultraglitch::params::SliceRearrange_Mix, // ID from tasq.md
-            "Rearrange Mix",
-            "", // No label in tasq.md
-            ParameterType::Float,
-            0.0f, 1.0f, 0.01f, 1.0f, 0.0f, // Range 0-1, default 0
-            {}
-        },
-        
-        // Weird Flanger parameters
-        {
-            ultraglitch::params::WeirdFlanger_Enabled, // ID from tasq.md
-            "Flanger Enabled",
-            "", // No label in tasq.md
-            ParameterType::Bool,
-            0.0f, 1.0f, 1.0f, 1.0f, 0.0f, // false by default
-            {}
-        },
-        {
-            ultraglitch::params::WeirdFlanger_Rate, // ID from tasq.md
-            "Flanger Rate",
-            "Hz",
-            ParameterType::Float,
-            0.01f, 20.0f, 0.01f, 0.5f, 1.0f, // Range 0.01-20Hz, default 1.0Hz
-            {}
-        },
-        {
-            ultraglitch::params::WeirdFlanger_Depth, // ID from tasq.md
-            "Flanger Depth",
-            "", // No label in tasq.md
-            ParameterType::Float,
-            0.0f, 1.0f, 0.01f, 1.0f, 0.8f, // Range 0-1, default 0.8
-            {}
-        },
-        {
-            ultraglitch::params::WeirdFlanger_Feedback, // ID from tasq.md
-            "Flanger Feedback",
-            "", // No label in tasq.md
-            ParameterType::Float,
-            -1.0f, 1.0f, 0.01f, 1.0f, 0.0f, // Range -1 to 1, default 0
-            {}
-        },
-        {
-            ultraglitch::params::WeirdFlanger_Mix, // ID from tasq.md
-            "Flanger Mix",
-            "", // No label in tasq.md
-            ParameterType::Float,
-            0.0f, 1.0f, 0.01f, 1.0f, 0.0f, // Range 0-1, default 0
-            {}
-        },
-        
-        // Chaos Controller parameters
-        // Note: ChaosController is enabled via Global_ChaosMode
-        {
-            ultraglitch::params::ChaosController_Speed, // ID from tasq.md
-            "Chaos Speed",
-            "Hz",
-            ParameterType::Float,
-            0.01f, 10.0f, 0.01f, 0.5f, 4.0f, // Range 0.01-10Hz, default 4.0Hz
-            {}
-        },
-        {
-            ultraglitch::params::ChaosController_Intensity, // ID from tasq.md
-            "Chaos Intensity",
-            "%",
-            ParameterType::Float,
-            0.0f, 100.0f, 1.0f, 1.0f, 100.0f, // Range 0-100, default 100%
-            {}
-        }
-    };
-    return definitions;
-}
\ No newline at end of file
+    set_parameter_values(batch); // One undo step
+}
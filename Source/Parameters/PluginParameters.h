@@ -5,31 +5,15 @@
 #include <juce_core/juce_core.h>
 #include <vector>
 #include <memory>
+#include <array>
+#include <atomic>
+#include "../Common/ParameterIDs.h"
+#include "ParameterHandle.h"
+#include "ParameterRegistry.h"
 
 // Forward declarations
 class ParameterListener;
 
-enum class ParameterType
-{
-    Float,
-    Bool,
-    Choice
-};
-
-struct ParameterDefinition
-{
-    juce::String id;
-    juce::String name;
-    juce::String label;
-    ParameterType type;
-    float minValue;
-    float maxValue;
-    float stepValue;
-    float skewFactor;
-    float defaultValue;
-    std::vector<juce::String> choices;
-};
-
 class PluginParameters
 {
 public:
@@ -40,16 +24,41 @@ public:
     PluginParameters(const PluginParameters&) = delete;
     PluginParameters& operator=(const PluginParameters&) = delete;
     
-    // Static method to get all parameter definitions — returns const ref to avoid per-call allocation
-    static const std::vector<ParameterDefinition>& get_parameter_definitions();
+    // All parameter definitions, ordered by ParamIndex (compile-time table, no static init)
+    static constexpr const auto& get_parameter_definitions() { return ultraglitch::params::PARAMETER_REGISTRY; }
     
+    // Real (denormalized) values keyed by ParamIndex; setting an index twice keeps the last value
+    struct ParameterBatch
+    {
+        std::array<float, ultraglitch::params::NUM_PARAMETERS> values{};
+        ultraglitch::params::ParamMask mask = 0;
+
+        void set(ultraglitch::params::ParamIndex index, float value)
+        {
+            values[static_cast<size_t>(index)] = value;
+            mask |= ultraglitch::params::to_mask(index);
+        }
+
+        bool is_empty() const { return mask == 0; }
+        void clear() { mask = 0; }
+    };
+
     // Parameter value access
     float get_parameter_value(const juce::String& parameter_id) const;
+    std::atomic<float>* get_raw_parameter_value(ultraglitch::params::ParamIndex index) const; // Resolve once, load per block
+    ParameterHandle get_parameter_handle(ultraglitch::params::ParamIndex index) const;
     void set_parameter_value(const juce::String& parameter_id, float new_value);
+    void set_parameter_value(ultraglitch::params::ParamIndex index, float new_value);
     juce::String get_parameter_text(const juce::String& parameter_id) const;
+
+    // Message thread: applies every value in the batch inside one overlapping change
+    // gesture (one undo step in hosts that group gestures) and notifies ParameterListeners
+    // once for the whole batch instead of once per parameter.
+    void set_parameter_values(const ParameterBatch& batch);
     
     // Direct parameter access
     juce::RangedAudioParameter* get_parameter(const juce::String& parameter_id) const;
+    juce::RangedAudioParameter* get_parameter(ultraglitch::params::ParamIndex index) const; // Cached, no lookup
     
     // Value tree state access
     juce::AudioProcessorValueTreeState& get_value_tree_state();
@@ -69,9 +78,35 @@ public:
     
     // Reset to defaults
     void reset_to_defaults();
+
+    // Change tracking (wait-free). Any thread that changes a parameter sets its bit;
+    // the audio thread drains the mask once per (sub-)block and only applies what moved.
+    ultraglitch::params::ParamMask consume_dirty_parameters();
+    void mark_all_parameters_dirty();
+
+    // Message thread: pushes values the audio thread already applied (chaos) to the
+    // host/GUI without flagging them dirty, so a late echo can't overwrite newer DSP state.
+    // Batched like set_parameter_values().
+    void publish_parameter_values(const ParameterBatch& batch);
+    void publish_parameter_value(ultraglitch::params::ParamIndex index, float new_real_value);
     
 private:
+    // Per-parameter APVTS listener that knows its own index, so no string
+    // compare happens on the (possibly real-time) thread that changed the value.
+    struct DirtyFlagListener : public juce::AudioProcessorValueTreeState::Listener
+    {
+        void parameterChanged(const juce::String& parameterID, float newValue) override;
+
+        PluginParameters* owner = nullptr;
+        ultraglitch::params::ParamIndex index = ultraglitch::params::ParamIndex::Count;
+    };
+
     juce::AudioProcessorValueTreeState apvts_;
+    std::array<DirtyFlagListener, ultraglitch::params::NUM_PARAMETERS> dirty_flag_listeners_;
+    std::atomic<ultraglitch::params::ParamMask> dirty_parameters_{ ultraglitch::params::ALL_PARAMETERS_MASK };
+    std::array<juce::RangedAudioParameter*, ultraglitch::params::NUM_PARAMETERS> parameters_{}; // By ParamIndex
+    std::atomic<ultraglitch::params::ParamMask> publishing_mask_{ 0 }; // Being published (listeners skip the dirty bit)
+    bool batch_in_progress_ = false; // Message thread only; per-parameter listener calls are coalesced
     std::vector<std::unique_ptr<juce::ParameterAttachment>> parameter_attachments_;
     juce::ListenerList<ParameterListener> parameter_listeners_;
     
@@ -83,6 +118,8 @@ private:
     
     // Handle parameter changes
     void handle_parameter_change(const juce::String& parameter_id, float new_value);
+    void mark_parameter_dirty(ultraglitch::params::ParamIndex index);
+    void apply_batch(const ParameterBatch& batch, bool publishing);
 };
 
 class ParameterListener
@@ -91,6 +128,18 @@ public:
     virtual ~ParameterListener() = default;
     
     virtual void parameter_changed(const juce::String& parameter_id, float new_value) = 0;
+
+    // One call per PluginParameters batch; by default forwarded per parameter
+    virtual void parameters_changed(ultraglitch::params::ParamMask changed,
+                                    const std::array<float, ultraglitch::params::NUM_PARAMETERS>& values)
+    {
+        for (; changed != 0; changed &= changed - 1)
+        {
+            const auto index = ultraglitch::params::lowest_set_index(changed);
+            parameter_changed(ultraglitch::params::to_juce_string(ultraglitch::params::get_parameter_spec(index).id),
+                              values[static_cast<size_t>(index)]);
+        }
+    }
 };
 
 #endif // PLUGINPARAMETERS_H
\ No newline at end of file
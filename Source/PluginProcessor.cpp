@@ -4,6 +4,7 @@
 #include "DSP/EffectChain.h"
 #include "DSP/EffectBase.h"
 #include "Common/ParameterIDs.h"
+#include "Common/PluginConfig.h"
 #include "DSP/Effects/ChaosController.h"
 
 // Effect includes
@@ -15,6 +16,7 @@
 #include "DSP/Effects/WeirdFlanger.h"
 
 //==============================================================================
+
 UltraGlitchAudioProcessor::UltraGlitchAudioProcessor()
     : AudioProcessor (BusesProperties()
                     #if ! JucePlugin_IsMidiEffect
@@ -27,12 +29,8 @@ UltraGlitchAudioProcessor::UltraGlitchAudioProcessor()
       plugin_parameters_(*this),
       effect_chain_()
 {
-    // Warm up the static parameter definitions so the vector is constructed
-    // on the main thread before any audio processing begins
-    (void) PluginParameters::get_parameter_definitions();
-    
     initializeEffectChain();
-    startTimerHz(30); // Start timer to check for ChaosController randomization requests
+    startTimerHz(30); // Publishes audio-thread parameter changes (chaos) to the host
 }
 
 UltraGlitchAudioProcessor::~UltraGlitchAudioProcessor()
@@ -75,7 +73,14 @@ bool UltraGlitchAudioProcessor::isMidiEffect() const
 
 double UltraGlitchAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // Follows the enabled effects and their current settings; infinity (e.g. flanger
+    // feedback at +/-1) becomes an infinite tail in the VST3/AU wrappers
+    const double sampleRate = getSampleRate();
+    const int hostRateLimiterSamples = output_limiters_.get<float>().getLatencySamples()
+                                     + output_limiters_.get<double>().getLatencySamples();
+
+    return effect_chain_.getTailLengthSeconds()
+         + (sampleRate > 0.0 ? hostRateLimiterSamples / sampleRate : 0.0);
 }
 
 int UltraGlitchAudioProcessor::getNumPrograms()
@@ -107,12 +112,89 @@ void UltraGlitchAudioProcessor::changeProgramName (int index, const juce::String
 //==============================================================================
 void UltraGlitchAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    effect_chain_.prepareToPlay(sampleRate, samplesPerBlock);
+    // The host sets the processing precision before preparing, and keeps it until the next prepare
+    const bool doublePrecision = isUsingDoublePrecision();
+    const int numChannels = juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels());
+
+    prepared_settings_ = read_engine_settings();
+
+    // Internal-rate mode: the chain runs at sampleRate / factor between the converters. Only
+    // the precision in use gets one; factor 1 frees the other (and means "off")
+    const int rateFactor = prepared_settings_.internalRate
+        ? ultraglitch::config::get_internal_rate_factor(sampleRate) : 1;
+    rate_converters_.get<float>().prepare(numChannels, doublePrecision ? 1 : rateFactor, samplesPerBlock);
+    rate_converters_.get<double>().prepare(numChannels, doublePrecision ? rateFactor : 1, samplesPerBlock);
+
+    // Hosts switch to offline rendering before preparing for it; oversampled effects pick
+    // their offline factor then
+    const int oversamplingFactor = prepared_settings_.oversamplingFactor;
+    const int offlineOversamplingFactor = oversamplingFactor == 1
+        ? 1 : juce::jmax(oversamplingFactor, ultraglitch::config::DEFAULT_OVERSAMPLING_FACTOR_OFFLINE);
+    bit_crusher_->setOversamplingFactors(oversamplingFactor, offlineOversamplingFactor);
+    weird_flanger_->setOversamplingFactors(oversamplingFactor, offlineOversamplingFactor);
+    effect_chain_.setNonRealtime(isNonRealtime());
+    // The limiter goes last at the host rate: behind the converter, the upsampling filter's
+    // overshoot would come after it. The chain's own is used when there is no converter.
+    const bool limiterEnabled = prepared_settings_.outputLimiter;
+    effect_chain_.setLimiterEnabled(limiterEnabled && rateFactor == 1);
+    effect_chain_.prepareToPlay(sampleRate / rateFactor, samplesPerBlock, numChannels, doublePrecision);
+
+    output_limiters_.get<float>().release();
+    output_limiters_.get<double>().release();
+    if (limiterEnabled && rateFactor > 1)
+    {
+        if (doublePrecision)
+            output_limiters_.get<double>().prepare(numChannels, sampleRate, samplesPerBlock);
+        else
+            output_limiters_.get<float>().prepare(numChannels, sampleRate, samplesPerBlock);
+    }
+
+    // Converter and host-rate limiter latency are in host samples; the chain's (oversampling
+    // filters, its limiter) at its own rate
+    const int converterLatency = doublePrecision ? rate_converters_.get<double>().getLatencySamples()
+                                                 : rate_converters_.get<float>().getLatencySamples();
+    const int hostRateLimiterLatency = output_limiters_.get<float>().getLatencySamples()
+                                     + output_limiters_.get<double>().getLatencySamples();
+    setLatencySamples(converterLatency + hostRateLimiterLatency + effect_chain_.getLatencySamples() * rateFactor);
+    is_prepared_ = true;
+    grid_position_ = 0;
+    resume_sub_block_ = false;
+    samples_since_split_ = 0;
+
+    // Derived DSP state depends on the sample rate, so re-apply every parameter once
+    plugin_parameters_.mark_all_parameters_dirty();
 }
 
 void UltraGlitchAudioProcessor::releaseResources()
 {
+    effect_chain_.releaseResources();
     effect_chain_.reset();
+    output_limiters_.get<float>().release();
+    output_limiters_.get<double>().release();
+    is_prepared_ = false;
+}
+
+UltraGlitchAudioProcessor::EngineSettings UltraGlitchAudioProcessor::read_engine_settings() const
+{
+    using ultraglitch::params::ParamIndex;
+
+    EngineSettings settings;
+    settings.internalRate = plugin_parameters_.get_parameter_handle(ParamIndex::Engine_InternalRate).load() >= 0.5f;
+    settings.outputLimiter = plugin_parameters_.get_parameter_handle(ParamIndex::Limiter_Enabled).load() >= 0.5f;
+    settings.oversamplingFactor = 1 << juce::jlimit(0, 3, juce::roundToInt(plugin_parameters_.get_parameter_handle(ParamIndex::Engine_Oversampling).load()));
+    return settings;
+}
+
+void UltraGlitchAudioProcessor::reprepare_if_prepared()
+{
+    // Re-prepare with the audio callback held off. JUCE tells the host about the new
+    // latency; otherwise the next prepareToPlay() picks it up
+    if (is_prepared_)
+    {
+        suspendProcessing(true);
+        prepareToPlay(getSampleRate(), getBlockSize());
+        suspendProcessing(false);
+    }
 }
 
 bool UltraGlitchAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
@@ -121,8 +203,10 @@ bool UltraGlitchAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
     juce::ignoreUnused (layouts);
     return true;
   #else
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any layout (mono, stereo, surround, ambisonic, discrete) up to MAX_NUM_CHANNELS;
+    // every effect runs on all channels
+    const auto& mainOutput = layouts.getMainOutputChannelSet();
+    if (mainOutput.isDisabled() || ! ultraglitch::config::is_valid_channel_count (mainOutput.size()))
         return false;
 
    #if ! JucePlugin_IsSynth
@@ -136,14 +220,109 @@ bool UltraGlitchAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
 
 void UltraGlitchAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
-    juce::ScopedNoDenormals noDenormals;
     juce::ignoreUnused(midiMessages);
+    process_samples(buffer);
+}
+
+void UltraGlitchAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    process_samples(buffer);
+}
+
+template <typename SampleType>
+void UltraGlitchAudioProcessor::process_samples (juce::AudioBuffer<SampleType>& buffer)
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    // Restart the chaos sequence and modulation sources whenever the transport starts, so
+    // playing from a given position and bouncing (at any speed) from it sound the same
+    if (auto* playHead = getPlayHead())
+    {
+        if (auto position = playHead->getPosition())
+        {
+            const bool isPlaying = position->getIsPlaying();
+            if (isPlaying && !was_playing_)
+            {
+                grid_position_ = 0; // Same sub-block boundaries as any other run from here
+                resume_sub_block_ = false;
+                if (chaos_controller_ != nullptr)
+                    chaos_controller_->restartSequence();
+                effect_chain_.getModulationMatrix().reset();
+            }
+            was_playing_ = isPlaying;
+        }
+    }
     
-    // Update effect chain parameters from APVTS
-    updateEffectChainParameters();
-    
-    // Process audio through effect chain
-    effect_chain_.process(buffer);
+    const int numSamples = buffer.getNumSamples();
+    auto& rateConverter = rate_converters_.get<SampleType>();
+
+    if (rateConverter.getFactor() == 1)
+    {
+        process_chain(buffer, numSamples);
+        return;
+    }
+
+    // Internal-rate mode: host chunks of at most the prepared block size go down to the
+    // internal rate, through the chain and back up in place, then through the limiter (the
+    // chain has applied the global gain)
+    auto& limiter = output_limiters_.get<SampleType>();
+
+    for (int startSample = 0; startSample < numSamples;)
+    {
+        const int chunkSamples = juce::jmin(numSamples - startSample, rateConverter.getMaxBlockSize());
+        const int internalSamples = rateConverter.downsample(buffer, startSample, chunkSamples);
+
+        process_chain(rateConverter.getInternalBuffer(), internalSamples);
+        rateConverter.upsample(buffer, startSample, chunkSamples);
+
+        if (limiter.isPrepared())
+        {
+            limiter.setCeilingDecibels(effect_chain_.getLimiterCeilingDecibels()); // As the chain last pulled it
+            limiter.process(buffer, startSample, chunkSamples, nullptr, 1.0f);
+        }
+
+        startSample += chunkSamples;
+    }
+}
+
+template <typename SampleType>
+void UltraGlitchAudioProcessor::process_chain (juce::AudioBuffer<SampleType>& buffer, int numSamples)
+{
+    // The chain runs in place on a fixed grid of INTERNAL_BLOCK_SIZE samples, continued
+    // across host blocks, and adds no latency. Within a grid cell the block is further split
+    // at internal change points (chaos triggers, reorders, modulation ticks); those splits
+    // are at least MIN_SUB_BLOCK_SAMPLES apart, measured across host blocks. Parameters are
+    // pulled only where the grid puts a sub-block boundary, so host and GUI changes land on
+    // the same control-rate points whatever the host block size. A host block that ends
+    // inside a sub-block still ends that process() call there, and the rest of the sub-block
+    // follows in the next one: effects that do per-call work (e.g. an LFO evaluated once per
+    // call and ramped) see that extra boundary. Host automation still arrives once per host
+    // block: the JUCE wrappers don't expose intra-block parameter offsets.
+    int startSample = 0;
+
+    while (startSample < numSamples)
+    {
+        // Only parameters that changed since the last grid point reach the effects
+        if (! resume_sub_block_)
+            effect_chain_.updateParameters(plugin_parameters_.consume_dirty_parameters());
+
+        const int samplesUntilGrid = ultraglitch::config::INTERNAL_BLOCK_SIZE - grid_position_;
+        const int samplesUntilChange = effect_chain_.getSamplesUntilNextChangePoint();
+        const int minSamples = juce::jmax(1, ultraglitch::config::MIN_SUB_BLOCK_SAMPLES - samples_since_split_);
+        const int gridSamples = juce::jmin(samplesUntilGrid, juce::jmax(minSamples, samplesUntilChange));
+        const int subBlockSamples = juce::jmin(numSamples - startSample, gridSamples);
+
+        // Process audio through effect chain, in place on the sub-range
+        effect_chain_.process(buffer, startSample, subBlockSamples);
+        startSample += subBlockSamples;
+        grid_position_ = (grid_position_ + subBlockSamples) % ultraglitch::config::INTERNAL_BLOCK_SIZE;
+        resume_sub_block_ = subBlockSamples < gridSamples; // Cut short by the end of the block
+
+        samples_since_split_ = subBlockSamples == samplesUntilChange
+            ? 0
+            : juce::jmin(ultraglitch::config::MIN_SUB_BLOCK_SAMPLES, samples_since_split_ + subBlockSamples);
+    }
 }
 
 //==============================================================================
@@ -161,6 +340,14 @@ juce::AudioProcessorEditor* UltraGlitchAudioProcessor::createEditor()
 void UltraGlitchAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
     auto state = plugin_parameters_.get_value_tree_state().copyState();
+
+    // Modulation routes live alongside the parameters; the APVTS ignores the extra child
+    const auto& modulation = effect_chain_.getModulationMatrix();
+    state.removeChild (state.getChildWithName (ultraglitch::dsp::ModulationMatrix::STATE_TYPE), nullptr);
+    state.appendChild (modulation.createState(), nullptr);
+    state.removeChild (state.getChildWithName (ultraglitch::dsp::EffectChain::ROUTING_STATE_TYPE), nullptr);
+    state.appendChild (effect_chain_.createRoutingState(), nullptr);
+
     std::unique_ptr<juce::XmlElement> xml (state.createXml());
     copyXmlToBinary (*xml, destData);
 }
@@ -171,29 +358,80 @@ void UltraGlitchAudioProcessor::setStateInformation (const void* data, int sizeI
 
     if (xmlState.get() != nullptr)
         if (xmlState->hasTagName (plugin_parameters_.get_value_tree_state().state.getType()))
-            plugin_parameters_.get_value_tree_state().replaceState (juce::ValueTree::fromXml (*xmlState));
+        {
+            auto state = juce::ValueTree::fromXml (*xmlState);
+            auto& modulation = effect_chain_.getModulationMatrix();
+
+            // Sessions saved before the modulation matrix existed clear all routes. The slot
+            // parameters then win over the saved routes they drive (next timer tick)
+            modulation.restoreState (state.getChildWithName (ultraglitch::dsp::ModulationMatrix::STATE_TYPE));
+            modulation_slots_stale_ = true;
+            effect_chain_.restoreRoutingState (state.getChildWithName (ultraglitch::dsp::EffectChain::ROUTING_STATE_TYPE)); // Older sessions: serial
+            plugin_parameters_.get_value_tree_state().replaceState (state);
+        }
 }
 
 //==============================================================================
 void UltraGlitchAudioProcessor::timerCallback()
 {
-    // Check if ChaosController has requested randomization
-    for (int i = 0; i < effect_chain_.getNumEffects(); ++i)
+    // Publish values the audio thread generated (ChaosController) to the host and GUI.
+    // The DSP already applied them sample-accurately; this only mirrors them. Everything
+    // queued since the last tick is coalesced (latest value per parameter) into one batch:
+    // one gesture and one listener notification, however many triggers happened.
+    std::array<ultraglitch::dsp::ParameterChange, 64> changes;
+    PluginParameters::ParameterBatch batch;
+    int numChanges = 0;
+
+    while ((numChanges = effect_chain_.popGeneratedParameterChanges(changes.data(), static_cast<int>(changes.size()))) > 0)
+    {
+        for (int i = 0; i < numChanges; ++i)
+            batch.set(changes[static_cast<size_t>(i)].index, changes[static_cast<size_t>(i)].value);
+    }
+
+    plugin_parameters_.publish_parameter_values(batch);
+
+    sync_modulation_slots();
+
+    // Engine settings only take effect in prepareToPlay(); host and GUI changes (including a
+    // state load) are picked up here, off the audio thread
+    if (is_prepared_ && read_engine_settings() != prepared_settings_)
+        reprepare_if_prepared();
+
+    // Free chain-order snapshots the audio thread has moved past
+    effect_chain_.reclaimRetiredOrders();
+}
+
+void UltraGlitchAudioProcessor::sync_modulation_slots()
+{
+    using namespace ultraglitch::params;
+    using ultraglitch::dsp::ModulationMatrix;
+    using ultraglitch::dsp::ModulationSource;
+
+    static_assert(count_choices(MODULATION_SOURCE_CHOICES) == ModulationMatrix::NUM_SOURCES,
+                  "One modulation source choice per ModulationSource");
+    static_assert(MODULATION_SLOT_PARAMETERS.size() <= static_cast<size_t>(ModulationMatrix::MAX_ROUTES),
+                  "Each modulation slot needs its own matrix route");
+
+    const bool applyAll = modulation_slots_stale_.exchange(false);
+    const auto load = [this](ParamIndex index) { return plugin_parameters_.get_parameter_handle(index).load(); };
+
+    for (size_t slot = 0; slot < MODULATION_SLOT_PARAMETERS.size(); ++slot)
     {
-        if (auto* effect = effect_chain_.getEffect(i))
+        const auto& parameters = MODULATION_SLOT_PARAMETERS[slot];
+        const int target = juce::roundToInt(load(parameters.target)); // 0 = None
+        ultraglitch::dsp::ModulationRoute route;
+
+        if (load(parameters.enabled) >= 0.5f && target > 0 && target <= static_cast<int>(MODULATION_TARGETS.size()))
         {
-            if (effect->getName() == "ChaosController")
-            {
-                // Cast to ChaosController* to access its specific methods
-                if (auto* chaosController = dynamic_cast<ultraglitch::dsp::ChaosController*>(effect))
-                {
-                    if (chaosController->shouldTriggerRandomization())
-                    {
-                        chaosController->randomizeParameters();
-                        // The shouldTriggerRandomization() getter clears the flag.
-                    }
-                }
-            }
+            route.source = static_cast<ModulationSource>(juce::jlimit(0, ModulationMatrix::NUM_SOURCES - 1, juce::roundToInt(load(parameters.source))));
+            route.destination = MODULATION_TARGETS[static_cast<size_t>(target - 1)];
+            route.depth = load(parameters.depth);
+        }
+
+        if (applyAll || route != modulation_slot_routes_[slot])
+        {
+            modulation_slot_routes_[slot] = route;
+            effect_chain_.getModulationMatrix().setRoute(static_cast<int>(slot), route);
         }
     }
 }
@@ -201,28 +439,27 @@ void UltraGlitchAudioProcessor::timerCallback()
 //==============================================================================
 void UltraGlitchAudioProcessor::initializeEffectChain()
 {
-    // Add all effects to the effect chain
-    effect_chain_.addEffect(std::make_unique<ultraglitch::dsp::BitCrusher>());
-    effect_chain_.addEffect(std::make_unique<ultraglitch::dsp::BufferStutter>());
-    effect_chain_.addEffect(std::make_unique<ultraglitch::dsp::PitchDrift>());
-    effect_chain_.addEffect(std::make_unique<ultraglitch::dsp::ReverseSlice>());
-    effect_chain_.addEffect(std::make_unique<ultraglitch::dsp::SliceRearrange>());
-    effect_chain_.addEffect(std::make_unique<ultraglitch::dsp::WeirdFlanger>());
-    effect_chain_.addEffect(std::make_unique<ultraglitch::dsp::ChaosController>(&plugin_parameters_)); // Pass PluginParameters to ChaosController
-}
+    // Each effect resolves its ParameterHandles from plugin_parameters_ at construction
+    effect_chain_.bindGlobalParameters(&plugin_parameters_);
 
-void UltraGlitchAudioProcessor::updateEffectChainParameters()
-{
-    // Iterate through all defined parameters and push their current values to the EffectChain
-    for (const auto& param_info : PluginParameters::get_parameter_definitions())
-    {
-        // Get the parameter value from the APVTS managed by plugin_parameters_
-        float value = plugin_parameters_.get_parameter_value(param_info.id);
-        
-        // Pass the parameter ID and its value to the EffectChain
-        // The EffectChain will then route this parameter to the relevant effect
-        effect_chain_.setParameterValue(param_info.id, value);
-    }
+    // The crusher's quantizer and the flanger's feedback alias at 1x, so those two run
+    // oversampled (Engine_Oversampling sets the factor at prepare)
+    auto bitCrusher = std::make_unique<ultraglitch::dsp::OversampledEffect<ultraglitch::dsp::BitCrusher>>(&plugin_parameters_);
+    bit_crusher_ = bitCrusher.get();
+    effect_chain_.addEffect(std::move(bitCrusher));
+
+    effect_chain_.addEffect(std::make_unique<ultraglitch::dsp::BufferStutter>(&plugin_parameters_));
+    effect_chain_.addEffect(std::make_unique<ultraglitch::dsp::PitchDrift>(&plugin_parameters_));
+    effect_chain_.addEffect(std::make_unique<ultraglitch::dsp::ReverseSlice>(&plugin_parameters_));
+    effect_chain_.addEffect(std::make_unique<ultraglitch::dsp::SliceRearrange>(&plugin_parameters_));
+
+    auto weirdFlanger = std::make_unique<ultraglitch::dsp::OversampledEffect<ultraglitch::dsp::WeirdFlanger>>(&plugin_parameters_);
+    weird_flanger_ = weirdFlanger.get();
+    effect_chain_.addEffect(std::move(weirdFlanger));
+
+    auto chaosController = std::make_unique<ultraglitch::dsp::ChaosController>(&plugin_parameters_);
+    chaos_controller_ = chaosController.get();
+    effect_chain_.addEffect(std::move(chaosController));
 }
 
 //==============================================================================
@@ -5,6 +5,15 @@
 #include <juce_gui_basics/juce_gui_basics.h> // For juce::Timer
 #include "Parameters/PluginParameters.h"
 #include "DSP/EffectChain.h"
+#include "DSP/InternalRateConverter.h"
+#include "DSP/OversampledEffect.h"
+#include "DSP/Effects/BitCrusher.h"
+#include "DSP/Effects/BufferStutter.h"
+#include "DSP/Effects/PitchDrift.h"
+#include "DSP/Effects/ReverseSlice.h"
+#include "DSP/Effects/SliceRearrange.h"
+#include "DSP/Effects/WeirdFlanger.h"
+#include "DSP/Effects/ChaosController.h"
 
 // Forward declarations
 class UltraGlitchAudioProcessorEditor;
@@ -20,6 +29,8 @@ public:
     void releaseResources() override;
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override;
+    void processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; } // Same DSP, instantiated for double
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -40,19 +51,85 @@ public:
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
-    // Timer callback for ChaosController randomization
+    // Timer callback: publishes ChaosController values to the host and applies the
+    // modulation slot parameters to the matrix
     void timerCallback() override;
 
     PluginParameters& getPluginParameters() { return plugin_parameters_; }
     ultraglitch::dsp::EffectChain& getEffectChain() { return effect_chain_; }
 
+    // Chain routing (EffectChain::setRouting()): stages of parallel branches over effect
+    // indices (0 BitCrusher ... 6 ChaosController); an invalid or empty routing is serial.
+    // Saved with the session. Message thread; the audio thread switches behind the reorder fade.
+    void setRouting(const std::vector<ultraglitch::dsp::EffectChain::RoutingStage>& stages) { effect_chain_.setRouting(stages); }
+    std::vector<ultraglitch::dsp::EffectChain::RoutingStage> getRouting() const { return effect_chain_.getRouting(); }
+
 private:
+    // Engine settings parameters, read by prepareToPlay() only: they change the latency.
+    // Internal-rate mode: at host rates of 88.2k and up the chain runs at 44.1/48k behind a
+    // resampler (less CPU, rate-independent character), adding the resampler's round trip
+    // (126, 282 or 594 host samples at 2x, 4x or 8x) to the reported latency.
+    // Output limiter: keeps true peaks under the Limiter_Ceiling parameter after the global
+    // gain, adding its lookahead (about 1.5 ms) to the latency. It runs at the host rate, after
+    // the internal-rate converter's upsampling (the chain's own limiter otherwise).
+    // Oversampling: the realtime factor of the BitCrusher and WeirdFlanger wrappers; offline
+    // rendering uses at least DEFAULT_OVERSAMPLING_FACTOR_OFFLINE, except at 1x (no filters, no
+    // latency). Their filters' latency counts while the effect is bypassed too (see EffectChain).
+    struct EngineSettings
+    {
+        bool internalRate = false;
+        bool outputLimiter = false;
+        int oversamplingFactor = ultraglitch::config::DEFAULT_OVERSAMPLING_FACTOR_REALTIME;
+
+        bool operator==(const EngineSettings& other) const
+        {
+            return internalRate == other.internalRate && outputLimiter == other.outputLimiter
+                && oversamplingFactor == other.oversamplingFactor;
+        }
+
+        bool operator!=(const EngineSettings& other) const { return !(*this == other); }
+    };
+
+    EngineSettings read_engine_settings() const;
+
+    // Message thread: settings that change the latency take effect by re-preparing
+    void reprepare_if_prepared();
+
+    // Message thread: modulation slot parameters -> ModulationMatrix routes, for the slots
+    // that changed since the last call (all of them after a state load)
+    void sync_modulation_slots();
+
+    // The effect set is fixed: effect index = order added (chaos last)
+    void initializeEffectChain();
+
+    // Both processBlock() overloads: transport handling and the sub-block loop
+    template <typename SampleType>
+    void process_samples(juce::AudioBuffer<SampleType>& buffer);
+
+    // The first numSamples of buffer through the chain, at the chain's rate, in sub-blocks
+    // on the grid
+    template <typename SampleType>
+    void process_chain(juce::AudioBuffer<SampleType>& buffer, int numSamples);
+
     PluginParameters plugin_parameters_;
     ultraglitch::dsp::EffectChain effect_chain_;
 
-    // Private helper methods (may be moved to .cpp later)
-    void initializeEffectChain();
-    void updateEffectChainParameters();
+    ultraglitch::dsp::ChaosController* chaos_controller_ = nullptr; // Owned by effect_chain_
+    ultraglitch::dsp::OversampledEffect<ultraglitch::dsp::BitCrusher>* bit_crusher_ = nullptr; // Owned by effect_chain_
+    ultraglitch::dsp::OversampledEffect<ultraglitch::dsp::WeirdFlanger>* weird_flanger_ = nullptr; // Owned by effect_chain_
+
+    bool was_playing_ = false; // Transport state of the previous block (audio thread)
+    int samples_since_split_ = 0; // Since the last change-point split, saturates at MIN_SUB_BLOCK_SAMPLES
+    int grid_position_ = 0; // Position in the current INTERNAL_BLOCK_SIZE grid cell, across host blocks
+    bool resume_sub_block_ = false; // The last block ended inside a sub-block: no parameter pull where it resumes
+
+    std::array<ultraglitch::dsp::ModulationRoute, ultraglitch::params::MODULATION_SLOT_PARAMETERS.size()> modulation_slot_routes_{}; // Last applied (message thread)
+    std::atomic<bool> modulation_slots_stale_ { true }; // Routes were rewritten (state load): re-apply every slot
+
+    EngineSettings prepared_settings_; // As of the last prepareToPlay(); the timer re-prepares when the parameters differ
+    bool is_prepared_ = false; // Between prepareToPlay() and releaseResources() (message thread)
+    ultraglitch::dsp::PrecisionStates<ultraglitch::dsp::InternalRateConverter> rate_converters_; // Factor 1 = off
+    ultraglitch::dsp::PrecisionStates<ultraglitch::dsp::TruePeakLimiter> output_limiters_; // Internal-rate mode only, precision in use
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(UltraGlitchAudioProcessor)
 };